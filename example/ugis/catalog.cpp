@@ -29,15 +29,18 @@ public:
         };
     }
 
-    boat::db::rowset select(boat::db::table const&,
-                            boat::db::page const&) override
+    boat::db::rowset select(  //
+        boat::db::table const&,
+        boat::db::page const&,
+        std::stop_token) override
     {
         throw err;
     }
 
     boat::db::rowset select(  //
         boat::db::table const&,
-        boat::db::bbox const& rq) override
+        boat::db::bbox const& rq,
+        std::stop_token) override
     {
         auto ret = boat::db::rowset{.columns{column_name}};
         auto mbr = boat::geometry::cartesian::box{
@@ -50,6 +53,23 @@ public:
         return ret;
     }
 
+    std::generator<boat::db::rowset> select(
+        boat::db::table tbl,
+        std::vector<boat::db::bbox> rqs,
+        std::stop_token tok) override
+    {
+        for (auto& rq : rqs)
+            co_yield select(tbl, rq, tok);
+    }
+
+    std::generator<boat::db::rowset> scan(boat::db::table,
+                                          std::vector<std::string>,
+                                          size_t) override
+    {
+        throw err;
+        co_return;
+    }
+
     void insert(  //
         boat::db::table const&,
         boat::db::rowset const&,
@@ -66,7 +86,8 @@ public:
 
     std::generator<std::pair<boat::tile, boat::gil::any_image>> read(
         boat::db::raster,
-        std::vector<boat::tile>) override
+        std::vector<boat::tile>,
+        std::stop_token) override
     {
         throw err;
         co_return;
@@ -93,3 +114,51 @@ std::unique_ptr<boat::db::catalog> make_catalog(std::string_view address)
         return std::make_unique<echo>();
     return boat::make_catalog(address);
 }
+
+namespace {
+
+boat::catalog_pool& pool()
+{
+    static auto ret = boat::catalog_pool{{}, make_catalog};
+    return ret;
+}
+
+std::string read_only(std::string_view address)
+{
+    if (!address.starts_with("sqlite://") || address.contains(":memory:") ||
+        address.contains('?'))
+        return {};
+    return boat::concat(address, "?mode=ro");
+}
+
+}  // namespace
+
+boat::catalog_pool::lease lease_catalog(std::string_view address)
+{
+    return pool().get(address);
+}
+
+std::function<std::shared_ptr<boat::db::catalog>()> lease_reader(
+    std::string_view address)
+{
+    auto adr = read_only(address);
+    if (adr.empty())
+        return {};
+    return [adr] { return pool().get_shared(adr); };
+}
+
+std::shared_ptr<boat::gui::pyramid> open_pyramid(std::string_view address,
+                                                 boat::db::layer const& layer)
+{
+    if (layer.raster || read_only(address).empty())
+        return {};
+    return std::make_shared<boat::gui::pyramid>(make_catalog(boat::concat(
+        address, ".", layer.table_name, ".", layer.column_name, ".lod")));
+}
+
+void release_catalogs(std::string_view address)
+{
+    pool().clear(address);
+    if (auto adr = read_only(address); !adr.empty())
+        pool().clear(adr);
+}
@@ -3,9 +3,25 @@
 #ifndef CATALOG_H
 #define CATALOG_H
 
-#include <boat/db/catalog.hpp>
+#include <boat/catalog_pool.hpp>
+#include <boat/gui/pyramid.hpp>
+#include <functional>
 #include <memory>
 
 std::unique_ptr<boat::db::catalog> make_catalog(std::string_view address);
 
+/// warm connection, returned to the pool on destruction
+boat::catalog_pool::lease lease_catalog(std::string_view address);
+
+/// leases a read-only connection per call, empty if not supported
+std::function<std::shared_ptr<boat::db::catalog>()> lease_reader(
+    std::string_view address);
+
+/// simplified levels in a file next to a sqlite layer, null if not supported
+std::shared_ptr<boat::gui::pyramid> open_pyramid(std::string_view address,
+                                                 boat::db::layer const& layer);
+
+/// closes idle connections after the address content has changed
+void release_catalogs(std::string_view address);
+
 #endif  // CATALOG_H
@@ -14,7 +14,7 @@ void copy_raster(  //
 {
     if (tok.stop_requested())
         return;
-    auto cat1 = make_catalog(src.address);
+    auto cat1 = lease_catalog(src.address);
     auto rast1 = cat1->get_raster(src.layer);
     if (tok.stop_requested())
         return;
@@ -39,6 +39,9 @@ void copy_raster(  //
         qInfo() << "copied" << done << "tiles";
     }
     qInfo() << "copied all tiles";
+    cat2.build_overviews(rast2, "average", tok);
+    if (!tok.stop_requested())
+        qInfo() << "built overviews";
 }
 
 leaf copy_vector(  //
@@ -53,7 +56,7 @@ leaf copy_vector(  //
     ret.cache = boat::gui::caches::next_key();
     if (tok.stop_requested())
         return ret;
-    auto cat1 = make_catalog(src.address);
+    auto cat1 = lease_catalog(src.address);
     auto tbl1 = cat1->get_table(src.layer.schema_name, src.layer.table_name);
     if (tok.stop_requested())
         return ret;
@@ -72,11 +75,8 @@ leaf copy_vector(  //
     ret.layer.table_name = tbl2.table_name;
     cat2->set_autocommit(false);
     qInfo() << "copying rows";
-    for (size_t done{};;) {
-        auto rs =
-            cat1->select(tbl1, boat::db::page{.offset = done, .limit = 20'000});
-        if (rs.empty())
-            break;
+    auto done = size_t{};
+    for (auto&& rs : cat1->scan(tbl1, {}, 20'000)) {
         cat2->insert(tbl2, rs, tok);
         if (tok.stop_requested())
             break;
@@ -108,6 +108,7 @@ void map_view::schedule_paint()
 void map_view::set_layers(std::vector<leaf> layers)
 {
     layers_ = std::move(layers);
+    update_pyramids();
     redraw();
 }
 
@@ -10,6 +10,7 @@
 #include <boat/geometry/raster.hpp>
 #include <boat/gui/caches/lru.hpp>
 #include <boat/gui/provider.hpp>
+#include <map>
 #include <memory>
 #include <optional>
 #include "task_group.h"
@@ -42,6 +43,7 @@ protected:
 private:
     void redraw();
     void schedule_paint();
+    void update_pyramids();
     void update_status(QPointF cursor);
     void watch_task(QFuture<void>);
 
@@ -60,6 +62,9 @@ private:
 
     std::optional<QPoint> panning_pos_;
     task_group tasks_;
+
+    std::map<size_t, std::shared_ptr<boat::gui::pyramid>> lods_;  //< by cache
+    task_group lod_tasks_{1};
 };
 
 #endif  // MAP_VIEW_H
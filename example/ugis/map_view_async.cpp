@@ -1,6 +1,8 @@
 // Andrew Naplavkov
 
 #include <QPainter>
+#include <atomic>
+#include <boat/geometry/wkb_view.hpp>
 #include <boat/gui/qt.hpp>
 #include "catalog.h"
 #include "geometry.h"
@@ -15,7 +17,7 @@ std::optional<point> any_lonlat(leaf const& lyr, std::stop_token tok)
 {
     if (tok.stop_requested())
         return {};
-    auto cat = make_catalog(lyr.address);
+    auto cat = lease_catalog(lyr.address);
     if (lyr.layer.raster) {
         auto rast = cat->get_raster(lyr.layer);
         auto crs = geo::srs::epsg(rast.epsg);
@@ -33,36 +35,49 @@ std::optional<point> any_lonlat(leaf const& lyr, std::stop_token tok)
     auto crs = geo::srs::epsg(it->epsg);
     if (tok.stop_requested())
         return {};
-    auto rs =
-        cat->select(tbl, boat::db::page{.select_list = {col}, .limit = 1});
+    auto rs = cat->select(
+        tbl, boat::db::page{.select_list = {col}, .limit = 1}, tok);
     if (rs.empty())
         return {};
     auto wkb = std::get_if<boat::blob>(&rs.value());
     if (!wkb)
         return {};
-    auto var = geo::geographic::variant{};
-    boat::blob_view{*wkb} >> var;
-    auto p = boat::overloaded{
-        [](geo::point auto&& v) -> std::optional<point> {
-            return point{v.x(), v.y()};
-        },
-        [](this auto&& self, geo::curve auto&& v) -> std::optional<point> {
-            return v.empty() ? std::nullopt : self(v.front());
-        },
-        [](this auto&& self, geo::polygon auto&& v) -> std::optional<point> {
-            return self(v.outer());
-        },
-        [](this auto&& self, geo::multi auto&& v) -> std::optional<point> {
-            return v.empty() ? std::nullopt : self(v.front());
-        },
-        [](this auto&& self, geo::dynamic auto&& v) -> std::optional<point> {
-            return std::visit(self, v);
-        },
-    }(var);
+    using cs = boost::geometry::coordinate_system<point>::type;
+    using d2 = geo::d2<cs>;
+    auto first = [](this auto&& self,
+                     geo::wkb_view<cs> const& g) -> std::optional<point> {
+        switch (g.index()) {
+            case geo::variant_index_v<d2::point>:
+            case geo::variant_index_v<d2::linestring>:
+                if (auto pts = g.points(); !pts.empty())
+                    return *pts.begin();
+                return {};
+            case geo::variant_index_v<d2::polygon>:
+                if (auto rings = g.rings(); !rings.empty()) {
+                    auto ring = *rings.begin();
+                    if (!ring.empty())
+                        return *ring.begin();
+                }
+                return {};
+        }
+        for (auto part : g.parts())
+            if (auto p = self(part))
+                return p;
+        return {};
+    };
+    auto p = first(geo::wkb_view<cs>{*wkb});
     return p ? geo::transform(geo::srs_inverse(geo::transformation(crs)))(*p)
              : std::nullopt;
 }
 
+/// offscreen buffers of the layers, composited in layer order
+struct frame {
+    std::vector<QImage> buffers;
+    std::atomic<size_t> pending;
+
+    explicit frame(size_t layers) : buffers(layers), pending{layers} {}
+};
+
 }  // namespace
 
 void map_view::locate(leaf lyr)
@@ -96,56 +111,112 @@ void map_view::redraw()
     auto mid = map_mid_;
     auto res = map_res_;
     tasks_.request_stop();
-    watch_task(tasks_.run([=, lyrs = layers_](auto tok) {
-        if (tok.stop_requested())
-            return;
-        auto cats = std::map<std::string, std::unique_ptr<boat::db::catalog>>{};
-        auto crs = geo::ortho(mid);
-        auto mat = affine(w, h, mid, res, crs);
-        auto num_points = static_cast<size_t>(
-            (w * h) / (boat::tile::size * boat::tile::size) + 1);
-        auto pvd = boat::gui::provider{
-            .cache = cache_,
-            .grid = geo::geographic_interpolate(w, h, mat, crs, num_points)};
+    auto crs = geo::ortho(mid);
+    auto mat = affine(w, h, mid, res, crs);
+    auto num_points = static_cast<size_t>(
+        (w * h) / (boat::tile::size * boat::tile::size) + 1);
+    auto grid = geo::geographic_interpolate(w, h, mat, crs, num_points);
+    auto frm = std::make_shared<frame>(layers_.size());
+    auto compose = [=, this](std::stop_token tok) {
         auto img = QImage{w, h, QImage::Format_RGBA8888};
         img.fill(Qt::white);
         auto art = QPainter{&img};
-        art.setRenderHint(QPainter::Antialiasing);
         art.setCompositionMode(QPainter::CompositionMode_Darken);
-        auto drw = boat::gui::draw_variant(std::execution::seq, art, mat, crs);
-        for (auto& l : lyrs)
-            try {
+        for (auto& buf : frm->buffers)
+            if (!buf.isNull())
+                art.drawImage(0, 0, buf);
+        art.end();
+        QMetaObject::invokeMethod(
+            this,
+            [=, this, img = std::move(img)] mutable {
                 if (tok.stop_requested())
                     return;
-                pvd.catalog = [&] -> boat::db::catalog& {
-                    auto& cat = cats[l.address];
-                    if (!cat)
-                        cat = make_catalog(l.address);
-                    return *cat;
-                };
-                pvd.layer = l.layer;
-                pvd.key = l.cache;
+                img_ = std::move(img);
+                img_mid_ = mid;
+                img_res_ = res;
+                update();
+            },
+            Qt::QueuedConnection);
+    };
+    if (layers_.empty())
+        watch_task(tasks_.run(compose));
+    for (auto [i, l] : std::views::enumerate(layers_)) {
+        auto it = lods_.find(l.cache);
+        auto lod = it == lods_.end() ? nullptr : it->second;
+        watch_task(tasks_.run([=, this](auto tok) {
+            if (tok.stop_requested())
+                return;
+            try {
+                auto img = QImage{w, h, QImage::Format_ARGB32_Premultiplied};
+                img.fill(Qt::transparent);
+                auto art = QPainter{&img};
+                art.setRenderHint(QPainter::Antialiasing);
+                art.setCompositionMode(QPainter::CompositionMode_Darken);
                 art.setPen(l.pen);
                 art.setBrush(l.brush);
+                auto drw =
+                    boat::gui::draw_variant(std::execution::seq, art, mat, crs);
+                auto cat = boat::catalog_pool::lease{};
+                auto pvd = boat::gui::provider{
+                    .catalog = [&] -> boat::db::catalog& {
+                        if (!cat)
+                            cat = lease_catalog(l.address);
+                        return *cat;
+                    },
+                    .layer = l.layer,
+                    .cache = cache_,
+                    .key = l.cache,
+                    .grid = grid,
+                    .token = tok,
+                    .reader = lease_reader(l.address),
+                    .readers = std::min<size_t>(
+                        std::thread::hardware_concurrency(),
+                        boat::catalog_pool::options{}.max_per_address),
+                    .lod = lod};
                 for (auto var : pvd.variants()) {
                     if (tok.stop_requested())
                         return;
                     std::visit(drw, var);
                 }
+                art.end();
+                frm->buffers[i] = std::move(img);
             }
             catch (std::exception const& e) {
                 qWarning() << "draw error:" << e.what();
             }
-        QMetaObject::invokeMethod(
-            this,
-            [=, img = std::move(img)] mutable {
-                if (tok.stop_requested())
-                    return;
-                img_ = std::move(img);
-                img_mid_ = mid;
-                img_res_ = res;
-                update();
-            },
-            Qt::QueuedConnection);
-    }));
+            if (--frm->pending == 0 && !tok.stop_requested())
+                compose(tok);
+        }));
+    }
+}
+
+void map_view::update_pyramids()
+{
+    for (auto& l : layers_) {
+        if (lods_.contains(l.cache))
+            continue;
+        auto lod = std::shared_ptr<boat::gui::pyramid>{};
+        try {
+            lod = open_pyramid(l.address, l.layer);
+        }
+        catch (std::exception const& e) {
+            qWarning() << "lod error:" << e.what();
+        }
+        lods_[l.cache] = lod;
+        if (!lod)
+            continue;
+        lod_tasks_.run([=](auto tok) {
+            try {
+                auto cat = lease_catalog(l.address);
+                auto tbl =
+                    cat->get_table(l.layer.schema_name, l.layer.table_name);
+                if (lod->levels().empty() ||
+                    !lod->fresh(*cat, tbl, l.layer.column_name, tok))
+                    lod->build(*cat, tbl, l.layer.column_name, 8, tok);
+            }
+            catch (std::exception const& e) {
+                qWarning() << "lod error:" << e.what();
+            }
+        });
+    }
 }
@@ -69,7 +69,7 @@ void tree_model::describe(QModelIndex const& idx)
         try {
             if (tok.stop_requested())
                 return;
-            auto cat = make_catalog(lyr.address);
+            auto cat = lease_catalog(lyr.address);
             if (lyr.layer.raster)
                 qInfo().noquote() << boat::concat(cat->get_raster(lyr.layer));
             else
@@ -95,7 +95,8 @@ void tree_model::drop(QModelIndex const& idx)
         try {
             if (tok.stop_requested())
                 return;
-            make_catalog(adr)->drop(scm, tbl);
+            lease_catalog(adr)->drop(scm, tbl);
+            release_catalogs(adr);
             qInfo() << "dropped"
                     << boat::concat(scm, scm.empty() ? "" : ".", tbl);
             QMetaObject::invokeMethod(
@@ -118,7 +119,7 @@ void tree_model::fetchMore(QModelIndex const& idx)
         try {
             auto children = std::vector<std::unique_ptr<tree>>{};
             if (!tok.stop_requested()) {
-                auto cat = make_catalog(src.address);
+                auto cat = lease_catalog(src.address);
                 for (auto& item : cat->sources())
                     children.push_back(std::make_unique<tree>(branch{item}));
                 for (auto& item : cat->layers())
@@ -157,6 +158,7 @@ void tree_model::paste(QModelIndex const& idx, QString const& name)
     tasks_.run([=, adr = b->source.address, nm = name.toStdString()](auto tok) {
         try {
             auto dst = copy_vector(src, adr.data(), nullptr, nm.data(), tok);
+            release_catalogs(adr);
             QMetaObject::invokeMethod(
                 this,
                 [=] {
@@ -182,7 +184,7 @@ void tree_model::sample(QModelIndex const& idx, viewport const& vp)
         try {
             if (tok.stop_requested())
                 return;
-            auto cat = make_catalog(lyr.address);
+            auto cat = lease_catalog(lyr.address);
             auto tbl =
                 cat->get_table(lyr.layer.schema_name, lyr.layer.table_name);
             auto& col = lyr.layer.column_name;
@@ -206,7 +208,8 @@ void tree_model::sample(QModelIndex const& idx, viewport const& vp)
                 auto a = box.min_corner(), b = box.max_corner();
                 auto rs = cat->select(
                     tbl,
-                    boat::db::bbox{{}, col, a.x(), a.y(), b.x(), b.y(), 10});
+                    boat::db::bbox{{}, col, a.x(), a.y(), b.x(), b.y(), 10},
+                    tok);
                 if (!rs.empty()) {
                     qInfo().noquote() << boat::concat(rs);
                     return;
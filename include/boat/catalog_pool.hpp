@@ -0,0 +1,199 @@
+// Andrew Naplavkov
+
+#ifndef BOAT_CATALOG_POOL_HPP
+#define BOAT_CATALOG_POOL_HPP
+
+#include <boat/catalogs.hpp>
+#include <boat/detail/config.hpp>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace boat {
+
+/// thread-safe reuse of open catalogs keyed by address
+class catalog_pool {
+public:
+    using clock = std::chrono::steady_clock;
+    using factory =
+        std::function<std::unique_ptr<db::catalog>(std::string_view)>;
+    using probe = std::function<void(db::catalog&)>;
+
+    struct options {
+        size_t max_per_address = 4;
+        clock::duration max_idle = std::chrono::minutes{5};
+        clock::duration probe_after = std::chrono::seconds{30};
+        clock::duration max_wait = timeout;
+    };
+
+    /// returns the catalog to the pool, unless released by an exception
+    class lease {
+        friend catalog_pool;
+        catalog_pool* pool_{};
+        std::string address_;
+        std::unique_ptr<db::catalog> cat_;
+        int exceptions_ = std::uncaught_exceptions();
+
+        lease(catalog_pool* pool,
+              std::string address,
+              std::unique_ptr<db::catalog> cat)
+            : pool_{pool}, address_{std::move(address)}, cat_{std::move(cat)}
+        {
+        }
+
+    public:
+        lease() = default;
+
+        lease(lease&& other) noexcept { swap(other); }
+
+        lease& operator=(lease&& other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        ~lease()
+        {
+            if (!pool_)
+                return;
+            if (std::uncaught_exceptions() > exceptions_)
+                cat_.reset();
+            pool_->put(address_, std::move(cat_));
+        }
+
+        void swap(lease& other) noexcept
+        {
+            std::swap(pool_, other.pool_);
+            std::swap(address_, other.address_);
+            std::swap(cat_, other.cat_);
+            std::swap(exceptions_, other.exceptions_);
+        }
+
+        void discard() { cat_.reset(); }
+        explicit operator bool() const { return !!cat_; }
+        db::catalog& operator*() const { return *cat_; }
+        db::catalog* operator->() const { return cat_.get(); }
+    };
+
+    explicit catalog_pool(
+        options opts = {},
+        factory make = make_catalog,
+        probe ping = [](db::catalog& cat) { cat.ping(); })
+        : opts_{opts}, make_{std::move(make)}, ping_{std::move(ping)}
+    {
+    }
+
+    lease get(std::string_view address)
+    {
+        evict();
+        auto key = std::string{address};
+        auto lock = std::unique_lock{guard_};
+        auto& slot = slots_[key];
+        check(cv_.wait_for(lock,
+                           opts_.max_wait,
+                           [&] {
+                               return !slot.idle.empty() ||
+                                      slot.leased < opts_.max_per_address;
+                           }),
+              "catalog_pool timeout");
+        ++slot.leased;
+        while (!slot.idle.empty()) {
+            auto item = std::move(slot.idle.back());
+            slot.idle.pop_back();
+            if (clock::now() - item.since < opts_.probe_after)
+                return {this, key, std::move(item.cat)};
+            lock.unlock();
+            if (healthy(*item.cat))
+                return {this, key, std::move(item.cat)};
+            item.cat.reset();
+            lock.lock();
+        }
+        lock.unlock();
+        try {
+            return {this, key, make_(key)};
+        }
+        catch (...) {
+            put(key, nullptr);
+            throw;
+        }
+    }
+
+    /// lease shared between holders, returned with the last one
+    std::shared_ptr<db::catalog> get_shared(std::string_view address)
+    {
+        auto ptr = std::make_shared<lease>(get(address));
+        return {ptr, &**ptr};
+    }
+
+    /// closes catalogs idle for longer than max_idle
+    void evict()
+    {
+        auto expired = std::vector<std::unique_ptr<db::catalog>>{};
+        auto lock = std::lock_guard{guard_};
+        auto now = clock::now();
+        for (auto& slot : slots_ | std::views::values)
+            std::erase_if(slot.idle, [&](auto& item) {
+                if (now - item.since < opts_.max_idle)
+                    return false;
+                expired.push_back(std::move(item.cat));
+                return true;
+            });
+    }
+
+    /// closes idle catalogs of the address, e.g. after schema changes
+    void clear(std::string_view address)
+    {
+        auto expired = std::vector<std::unique_ptr<db::catalog>>{};
+        auto lock = std::lock_guard{guard_};
+        if (auto it = slots_.find(std::string{address}); it != slots_.end())
+            for (auto& item : std::exchange(it->second.idle, {}))
+                expired.push_back(std::move(item.cat));
+    }
+
+private:
+    struct entry {
+        std::unique_ptr<db::catalog> cat;
+        clock::time_point since;
+    };
+
+    struct bucket {
+        std::vector<entry> idle;  //< most recently used last
+        size_t leased{};
+    };
+
+    options opts_;
+    factory make_;
+    probe ping_;
+    std::mutex guard_;
+    std::condition_variable cv_;
+    std::unordered_map<std::string, bucket> slots_;
+
+    bool healthy(db::catalog& cat) const
+    {
+        try {
+            ping_(cat);
+            return true;
+        }
+        catch (std::exception const&) {
+            return false;
+        }
+    }
+
+    void put(std::string const& address, std::unique_ptr<db::catalog> cat)
+    {
+        {
+            auto lock = std::lock_guard{guard_};
+            auto& slot = slots_[address];
+            --slot.leased;
+            if (cat)
+                slot.idle.push_back({std::move(cat), clock::now()});
+        }
+        cv_.notify_all();
+    }
+};
+
+}  // namespace boat
+
+#endif  // BOAT_CATALOG_POOL_HPP
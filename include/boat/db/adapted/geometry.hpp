@@ -18,7 +18,12 @@ void read(variant const& in, geometry::ogc99 auto& out)
 
 void write(variant& out, geometry::ogc99 auto const& in)
 {
-    out.emplace<blob>() << in;
+    auto wkb = std::get_if<blob>(&out);  //< reuse capacity across rows
+    if (wkb)
+        wkb->clear();
+    else
+        wkb = &out.emplace<blob>();
+    *wkb << in;
 }
 
 template <geometry::ogc99 T>
@@ -3,8 +3,8 @@
 #ifndef BOAT_DB_CATALOG_HPP
 #define BOAT_DB_CATALOG_HPP
 
+#include <boat/db/column_batch.hpp>
 #include <boat/db/meta.hpp>
-#include <boat/db/rowset.hpp>
 #include <boat/gil.hpp>
 #include <boat/tile.hpp>
 #include <generator>
@@ -19,16 +19,57 @@ struct catalog {
 
     virtual std::vector<layer> layers() = 0;
 
+    /// cheap round trip to the data source, throws if it is gone
+    virtual void ping() {}
+
     virtual table get_table(  //
         std::string_view schema_name,
         std::string_view table_name) = 0;
 
-    virtual rowset select(table const&, page const&) = 0;
-
-    virtual rowset select(table const&, bbox const&) = 0;
+    virtual rowset select(table const&, page const&, std::stop_token = {}) = 0;
+
+    virtual rowset select(table const&, bbox const&, std::stop_token = {}) = 0;
+
+    /// one rowset per request, submitted together if the driver can
+    virtual std::generator<rowset> select(table,
+                                          std::vector<bbox>,
+                                          std::stop_token = {}) = 0;
+
+    /// same as above without copying rows if the driver can
+    virtual void visit(table const& tbl,
+                       std::vector<bbox> rqs,
+                       row_visitor const& f,
+                       std::stop_token tok = {})
+    {
+        for_each_row(select(tbl, std::move(rqs), std::move(tok)), f);
+    }
+
+    virtual std::generator<rowset> scan(
+        table,
+        std::vector<std::string> select_list,
+        size_t batch_size) = 0;
+
+    /// same as above in columns, filled without row vectors if the driver can
+    virtual std::generator<column_batch> scan_columns(
+        table tbl,
+        std::vector<std::string> select_list,
+        size_t batch_size)
+    {
+        for (auto&& rs :
+             scan(std::move(tbl), std::move(select_list), batch_size))
+            co_yield to_column_batch(rs);
+    }
 
     virtual void insert(table const&, rowset const&, std::stop_token = {}) = 0;
 
+    /// same as above without building rows if the driver can
+    virtual void insert_columns(table const& tbl,
+                                column_batch const& cb,
+                                std::stop_token tok = {})
+    {
+        insert(tbl, to_rowset(cb), std::move(tok));
+    }
+
     virtual table create(table const&) = 0;
 
     virtual void drop(  //
@@ -39,7 +80,8 @@ struct catalog {
 
     virtual std::generator<std::pair<tile, gil::any_image>> read(
         raster,
-        std::vector<tile>) = 0;
+        std::vector<tile>,
+        std::stop_token = {}) = 0;
 
     virtual void write(raster const&, rect const&, gil::any_image_view) = 0;
 
@@ -0,0 +1,216 @@
+// Andrew Naplavkov
+
+#ifndef BOAT_DB_COLUMN_BATCH_HPP
+#define BOAT_DB_COLUMN_BATCH_HPP
+
+#include <boat/db/rowset.hpp>
+
+namespace boat::db {
+
+struct column_batch {
+    struct column {
+        static constexpr auto mixed = std::variant_npos;
+
+        std::string name;
+        size_t index{};                  //< variant alternative, null if none
+        std::vector<uint64_t> validity;  //< bitmap of non-null cells
+        std::vector<uint64_t> values;    //< integer, real or arena end offset
+        blob arena;                      //< string and blob payloads
+        std::vector<variant> cells;      //< instead of the above if mixed
+
+        size_t size() const
+        {
+            return index == mixed ? cells.size() : values.size();
+        }
+
+        bool has_value(size_t row) const
+        {
+            return validity[row / 64] >> row % 64 & 1;
+        }
+
+        variant value(size_t row) const { return own(view(row)); }
+
+        /// borrows string and blob payloads from the arena
+        variant_view view(size_t row) const
+        {
+            if (!has_value(row))
+                return {};
+            if (index == mixed)
+                return borrow(cells[row]);
+            auto val = values[row];
+            auto pos = row ? values[row - 1] : 0;
+            switch (index) {
+                case variant_index<variant_base, int64_t>():
+                    return std::bit_cast<int64_t>(val);
+                case variant_index<variant_base, double>():
+                    return std::bit_cast<double>(val);
+                case variant_index<variant_base, std::string>():
+                    return std::string_view{as_chars(arena.data() + pos),
+                                            val - pos};
+                case variant_index<variant_base, blob>():
+                    return blob_view{arena.data() + pos, val - pos};
+            }
+            throw std::runtime_error{"column_batch"};
+        }
+
+        void push_back(variant const& var) { push_back(borrow(var)); }
+
+        /// copies a borrowed payload straight into the arena
+        void push_back(variant_view var)
+        {
+            auto valid = !std::holds_alternative<null>(var);
+            if (valid)
+                promote(var.index());
+            if (size() % 64 == 0)
+                validity.push_back(0);
+            if (valid)
+                validity.back() |= 1ull << size() % 64;
+            if (index == mixed)
+                return cells.push_back(own(var));
+            auto vis = overloaded{
+                [&](null) {
+                    values.push_back(blob_like() ? arena.size() : 0);
+                },
+                [&](int64_t v) {
+                    values.push_back(
+                        index == variant_index<variant_base, double>()
+                            ? std::bit_cast<uint64_t>(static_cast<double>(v))
+                            : std::bit_cast<uint64_t>(v));
+                },
+                [&](double v) {
+                    values.push_back(std::bit_cast<uint64_t>(v));
+                },
+                [&](auto const& v) {
+                    arena.append_range(std::as_bytes(std::span{v}));
+                    values.push_back(arena.size());
+                }};
+            std::visit(vis, var);
+        }
+
+    private:
+        bool blob_like() const
+        {
+            return index == variant_index<variant_base, std::string>() ||
+                   index == variant_index<variant_base, blob>();
+        }
+
+        void promote(size_t other)
+        {
+            constexpr auto integer = variant_index<variant_base, int64_t>();
+            constexpr auto real = variant_index<variant_base, double>();
+            if (index == other || index == mixed ||
+                (index == real && other == integer))
+                return;
+            if (index == integer && other == real)
+                for (auto& v : values)
+                    v = std::bit_cast<uint64_t>(
+                        static_cast<double>(std::bit_cast<int64_t>(v)));
+            else if (index) {  //< dynamic typing, e.g. sqlite
+                cells.reserve(size() + 1);
+                for (size_t row{}; row < size(); ++row)
+                    cells.push_back(value(row));
+                values = {};
+                arena = {};
+                other = mixed;
+            }
+            index = other;
+        }
+    };
+
+    std::vector<column> columns;
+
+    size_t size() const { return columns.empty() ? 0 : columns[0].size(); }
+    bool empty() const { return !size(); }
+    variant value() const { return columns.at(0).value(0); }
+
+    auto row(size_t i) const
+    {
+        return columns |
+               std::views::transform([i](auto& col) { return col.value(i); });
+    }
+
+    auto row_view(size_t i) const
+    {
+        return columns |
+               std::views::transform([i](auto& col) { return col.view(i); });
+    }
+
+    auto rows() const
+    {
+        return std::views::iota(0uz, size()) |
+               std::views::transform([this](size_t i) { return row(i); });
+    }
+
+    /// same columns without rows
+    column_batch header() const
+    {
+        auto ret = column_batch{};
+        for (auto& col : columns)
+            ret.columns.emplace_back().name = col.name;
+        return ret;
+    }
+
+    void push_back(range_of<variant> auto&& row)
+    {
+        auto it = std::ranges::begin(row);
+        for (auto& col : columns) {
+            check(it != std::ranges::end(row), "out of columns");
+            col.push_back(*it++);
+        }
+        check(it == std::ranges::end(row), "out of columns");
+    }
+};
+
+inline column_batch to_column_batch(rowset const& rs)
+{
+    auto ret = column_batch{};
+    for (auto& name : rs.columns)
+        ret.columns.emplace_back().name = name;
+    for (auto& row : rs)
+        ret.push_back(row);
+    return ret;
+}
+
+column_batch to_column_batch(std::ranges::input_range auto&& r)
+    requires std::is_aggregate_v<std::ranges::range_value_t<decltype(r)>>
+{
+    auto ret = column_batch{};
+    for (auto& name :
+         boost::pfr::names_as_array<std::ranges::range_value_t<decltype(r)>>())
+        ret.columns.emplace_back().name = name;
+    auto var = variant{};
+    for (auto&& item : r) {
+        auto col = ret.columns.begin();
+        boost::pfr::for_each_field(item, [&](auto& v) {
+            write(var, v);
+            (col++)->push_back(var);
+        });
+    }
+    return ret;
+}
+
+/// blob column over the arena without copying encodings one by one
+inline column_batch::column to_column(std::string name,
+                                      geometry::wkb_arena arena)
+{
+    return {.name = std::move(name),
+            .index = variant_index<variant_base, blob>(),
+            .validity = std::vector<uint64_t>((arena.size() + 63) / 64, ~0ull),
+            .values{std::from_range, arena.offsets},
+            .arena = std::move(arena.bytes)};
+}
+
+inline rowset to_rowset(column_batch const& cb)
+{
+    auto ret = rowset{
+        cb.columns | std::views::transform(&column_batch::column::name) |
+        std::ranges::to<decltype(rowset::columns)>()};
+    ret.rows.reserve(cb.size());
+    for (auto row : cb.rows())
+        ret.rows.push_back(row | std::ranges::to<std::vector<variant>>());
+    return ret;
+}
+
+}  // namespace boat::db
+
+#endif  // BOAT_DB_COLUMN_BATCH_HPP
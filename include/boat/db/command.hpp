@@ -3,14 +3,42 @@
 #ifndef BOAT_DB_COMMAND_HPP
 #define BOAT_DB_COMMAND_HPP
 
+#include <boat/db/column_batch.hpp>
 #include <boat/db/query.hpp>
-#include <boat/db/rowset.hpp>
 
 namespace boat::db {
 
 struct command {
     virtual ~command() = default;
     virtual rowset exec(query const&) = 0;
+    virtual std::generator<rowset> exec_many(std::vector<query>) = 0;
+
+    virtual void visit(std::vector<query> qrys, row_visitor const& f)
+    {
+        for_each_row(exec_many(std::move(qrys)), f);
+    }
+
+    virtual std::generator<rowset> scan(query, size_t batch_size) = 0;
+
+    /// same as above in columns, filled without row vectors if the driver can
+    virtual std::generator<column_batch> scan_columns(query qry,
+                                                      size_t batch_size)
+    {
+        for (auto&& rs : scan(std::move(qry), batch_size))
+            co_yield to_column_batch(rs);
+    }
+
+    virtual bool copy(query const&, rowset const&) = 0;  //< false if no bulk
+
+    /// same as above, encoded straight from the arenas if the driver can
+    virtual bool copy_columns(query const& qry, column_batch const& cb)
+    {
+        return copy(qry, to_rowset(cb));
+    }
+
+    virtual bool exec_batch(query const&, rowset const& params) = 0;  //< same
+    virtual void cancel() = 0;  //< thread-safe, interrupts running query
+    virtual void reset_statements() {}  //< prepared before schema changes
     virtual void set_autocommit(bool) = 0;
     virtual void commit() = 0;
     virtual char id_quote() = 0;
@@ -3,6 +3,7 @@
 #ifndef BOAT_DB_META_HPP
 #define BOAT_DB_META_HPP
 
+#include <boat/db/variant.hpp>
 #include <cstdint>
 #include <ranges>
 #include <string>
@@ -74,6 +75,8 @@ struct bbox {
     double xmax;
     double ymax;
     int limit;
+    int sample{};                 //< random rows out of limit, if positive
+    double simplify_tolerance{};  //< in layer units, if positive
 };
 
 struct order_key {
@@ -84,6 +87,7 @@ struct order_key {
 struct page {
     std::vector<std::string> select_list;
     std::vector<order_key> order_by;
+    std::vector<variant> after;  //< keyset of the previous page's last row
     size_t offset;
     int limit;
 };
@@ -44,7 +44,18 @@ public:
         return *this;
     }
 
-    std::string text(char id_quote, std::string_view param_mark) const
+    query& operator<<(query const& other)
+    {
+        append_range(other);
+        return *this;
+    }
+
+    /// inlines parameters if there is no param_mark,
+    /// escaping strings with the driver's function if given
+    std::string text(
+        char id_quote,
+        std::string_view param_mark,
+        std::function<std::string(std::string_view)> const& escape = {}) const
     {
         auto os = std::ostringstream{};
         os.imbue(std::locale::classic());
@@ -53,7 +64,12 @@ public:
         auto param_vis = overloaded{
             [&](null) { os << "null"; },
             [&](arithmetic auto v) { os << v; },
-            [&](std::string_view v) { os << unicode::quoted(v, '\''); },
+            [&](std::string_view v) {
+                if (escape)
+                    os << "'" << escape(v) << "'";
+                else
+                    os << unicode::quoted(v, '\'');
+            },
             [&](blob_view v) { os << "x'" << hex{v} << "'"; }};
         auto item_vis = overloaded{
             [&](std::string const& v) { os << v; },
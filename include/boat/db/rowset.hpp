@@ -5,6 +5,7 @@
 
 #include <boat/db/adapted/adapted.hpp>
 #include <boost/pfr.hpp>
+#include <functional>
 #include <vector>
 
 namespace boat::db {
@@ -19,6 +20,23 @@ struct rowset {
     variant const& value() const { return rows.at(0).at(0); }
 };
 
+/// receives the query number and a row valid only during the call
+using row_visitor =
+    std::function<void(size_t query, std::span<variant_view const> row)>;
+
+void for_each_row(range_of<rowset> auto&& rowsets, row_visitor const& f)
+{
+    auto query = size_t{};
+    auto row = std::vector<variant_view>{};
+    for (auto&& rs : rowsets) {
+        for (auto& r : rs) {
+            row.assign_range(r | std::views::transform(borrow));
+            f(query, row);
+        }
+        ++query;
+    }
+}
+
 template <class T>
 constexpr auto view = std::views::transform([](range_of<variant> auto&& r) {
     T ret;
@@ -32,6 +50,7 @@ constexpr auto view = std::views::transform([](range_of<variant> auto&& r) {
 });
 
 rowset to_rowset(std::ranges::input_range auto&& r)
+    requires std::is_aggregate_v<std::ranges::range_value_t<decltype(r)>>
 {
     auto ret = rowset{
         boost::pfr::names_as_array<std::ranges::range_value_t<decltype(r)>>() |
@@ -19,6 +19,24 @@ struct variant : variant_base {
     void reset() { emplace<null>(); }
 };
 
+/// borrows string and blob payloads
+using variant_view =
+    std::variant<null, int64_t, double, std::string_view, blob_view>;
+
+inline variant_view borrow(variant const& var)
+{
+    return std::visit([](auto const& v) -> variant_view { return v; }, var);
+}
+
+inline variant own(variant_view var)
+{
+    auto vis = overloaded{
+        [](std::string_view v) { return variant{v}; },
+        [](blob_view v) { return variant{blob{v.data(), v.size()}}; },
+        [](auto v) { return variant{v}; }};
+    return std::visit(vis, var);
+}
+
 template <std::convertible_to<variant_base> T>
 void read(variant const& in, T& out)
 {
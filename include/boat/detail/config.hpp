@@ -4,12 +4,16 @@
 #define BOAT_CONFIG_HPP
 
 #include <chrono>
+#include <cstddef>
 
 namespace boat {
 
 /// common timeout for network and database operations
 constexpr auto timeout = std::chrono::seconds{30};
 
+/// prepared statements kept per database connection
+constexpr size_t statement_cache_size = 32;
+
 }  // namespace boat
 
 #endif  // BOAT_CONFIG_HPP
@@ -42,6 +42,12 @@ struct overloaded : Ts... {
     using Ts::operator()...;
 };
 
+template <std::invocable F>
+struct finally {
+    F f;
+    ~finally() { f(); }
+};
+
 constexpr auto as_bytes = [](auto* ptr) {
     return reinterpret_cast<std::byte const*>(ptr);
 };
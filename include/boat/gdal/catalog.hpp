@@ -31,24 +31,49 @@ struct catalog : db::catalog {
         return ret;
     }
 
+    void ping() override { GDALDatasetGetLayerCount(dataset.get()); }
+
     db::table get_table(std::string_view, std::string_view table_name) override
     {
-        return gdal::get_table(GDALDatasetGetLayerByName(
-            dataset.get(), std::string{table_name}.data()));
+        return gdal::get_table(layer(table_name));
     }
 
-    db::rowset select(db::table const& tbl, db::page const& rq) override
+    db::rowset select(  //
+        db::table const& tbl,
+        db::page const& rq,
+        std::stop_token = {}) override
     {
+        auto col = OGR_L_GetFIDColumn(layer(tbl.table_name));
+        auto fid = std::string_view{col ? col : ""};
         auto q = db::query{};
+        auto name = [&](db::order_key const& key) -> db::query& {
+            return key.column_name.empty() || key.column_name == fid
+                       ? q << "FID"
+                       : q << db::id{key.column_name};
+        };
+        auto keys = rq.order_by;
+        if (keys.empty() && !rq.after.empty())
+            keys.emplace_back();
+        boat::check(rq.after.empty() || rq.after.size() == keys.size(),
+                    "seek keys");
         q << "\n select";
-        if (auto col = OGR_L_GetFIDColumn(GDALDatasetGetLayerByName(
-                dataset.get(), tbl.table_name.data()));
-            col && std::strlen(col))
-            q << " FID as \"" << col << "\",";
+        if (!fid.empty())
+            q << " FID as \"" << fid << "\",";
         q << " * from " << db::id{tbl.table_name};
-        for (auto sep{"\n order by "}; auto& key : rq.order_by)
-            q << std::exchange(sep, ", ") << db::id{key.column_name}
-              << (key.descending ? " desc" : "");
+        for (size_t i{}; i < rq.after.size(); ++i) {
+            q << (i ? ")\n or (" : "\n where (");
+            for (size_t j{}; j <= i; ++j)
+                name(keys[j]) << (j < i                ? " = "
+                                  : keys[j].descending ? " < "
+                                                       : " > ")
+                              << rq.after[j] << (j < i ? " and " : "");
+        }
+        if (!rq.after.empty())
+            q << ")";
+        for (auto sep{"\n order by "}; auto& key : keys) {
+            q << std::exchange(sep, ", ");
+            name(key) << (key.descending ? " desc" : "");
+        }
         q << "\n limit " << to_chars(rq.limit) << "\n offset "
           << to_chars(rq.offset);
         if (auto lyr = execute(dataset.get(), q.text('"', {}).data(), "OGRSQL"))
@@ -57,10 +82,12 @@ struct catalog : db::catalog {
         return {};
     }
 
-    db::rowset select(db::table const& tbl, db::bbox const& rq) override
+    db::rowset select(  //
+        db::table const& tbl,
+        db::bbox const& rq,
+        std::stop_token = {}) override
     {
-        auto lyr =
-            GDALDatasetGetLayerByName(dataset.get(), tbl.table_name.data());
+        auto lyr = layer(tbl.table_name);
         auto fd = OGR_L_GetLayerDefn(lyr);
         OGR_L_SetSpatialFilterRectEx(
             lyr,
@@ -69,7 +96,53 @@ struct catalog : db::catalog {
             rq.ymin,
             rq.xmax,
             rq.ymax);
-        return gdal::select(lyr, fields::make(lyr, rq.select_list), rq.limit);
+        return gdal::select(lyr, fields::make(lyr, rq.select_list), rq);
+    }
+
+    std::generator<db::rowset> select(  //
+        db::table tbl,
+        std::vector<db::bbox> rqs,
+        std::stop_token tok = {}) override
+    {
+        for (auto& rq : rqs) {
+            if (tok.stop_requested())
+                break;
+            co_yield select(tbl, rq);
+        }
+    }
+
+    std::generator<db::rowset> scan(
+        db::table tbl,
+        std::vector<std::string> select_list,
+        size_t batch_size) override
+    {
+        auto lyr = layer(tbl.table_name);
+        OGR_L_SetSpatialFilter(lyr, nullptr);
+        OGR_L_ResetReading(lyr);
+        auto flds = fields::make(lyr, select_list);
+        for (auto limit = static_cast<int>(batch_size);;) {
+            auto rs = gdal::select(lyr, flds, limit);
+            if (rs.empty())
+                break;
+            co_yield std::move(rs);
+        }
+    }
+
+    std::generator<db::column_batch> scan_columns(
+        db::table tbl,
+        std::vector<std::string> select_list,
+        size_t batch_size) override
+    {
+        auto lyr = layer(tbl.table_name);
+        OGR_L_SetSpatialFilter(lyr, nullptr);
+        OGR_L_ResetReading(lyr);
+        auto flds = fields::make(lyr, select_list);
+        for (auto limit = static_cast<int>(batch_size);;) {
+            auto cb = gdal::select_columns(lyr, flds, limit);
+            if (cb.empty())
+                break;
+            co_yield std::move(cb);
+        }
     }
 
     void insert(  //
@@ -77,9 +150,7 @@ struct catalog : db::catalog {
         db::rowset const& rs,
         std::stop_token tok = {}) override
     {
-        auto lyr =
-            GDALDatasetGetLayerByName(dataset.get(), tbl.table_name.data());
-        gdal::insert(lyr, rs, tok);
+        gdal::insert(layer(tbl.table_name), rs, tok);
     }
 
     db::table create(db::table const& tbl) override
@@ -99,10 +170,14 @@ struct catalog : db::catalog {
 
     std::generator<std::pair<tile, gil::any_image>> read(
         db::raster rast,
-        std::vector<tile> ts) override
+        std::vector<tile> ts,
+        std::stop_token tok = {}) override
     {
-        for (auto& t : ts)
+        for (auto& t : ts) {
+            if (tok.stop_requested())
+                break;
             co_yield {t, gdal::read(dataset.get(), rast, t)};
+        }
     }
 
     void write(  //
@@ -113,12 +188,28 @@ struct catalog : db::catalog {
         gdal::write(dataset.get(), rast, rect, img);
     }
 
+    void build_overviews(db::raster const& rast,
+                         char const* resampling = "average",
+                         std::stop_token tok = {})
+    {
+        gdal::build_overviews(dataset.get(), rast, resampling, tok);
+    }
+
     void set_autocommit(bool on) override
     {
         gdal::set_autocommit(dataset.get(), on);
     }
 
     void commit() override { gdal::commit(dataset.get()); }
+
+private:
+    OGRLayerH layer(std::string_view table_name)
+    {
+        auto ret = GDALDatasetGetLayerByName(dataset.get(),
+                                             std::string{table_name}.data());
+        boat::check(!!ret, concat("no layer ", table_name));
+        return ret;
+    }
 };
 
 }  // namespace boat::gdal
@@ -21,6 +21,38 @@ struct command : db::command {
         return err.empty() ? db::rowset{} : throw std::runtime_error(err);
     }
 
+    std::generator<db::rowset> exec_many(std::vector<db::query> qrys) override
+    {
+        for (auto& qry : qrys)
+            co_yield exec(qry);
+    }
+
+    std::generator<db::rowset> scan(db::query qry, size_t batch_size) override
+    {
+        auto txt = qry.text(id_quote(), param_mark());
+        auto lyr = execute(dataset.get(), txt.data(), dialect.data());
+        if (!lyr) {
+            if (auto err = error_or(""); !err.empty())
+                throw std::runtime_error(err);
+            co_return;
+        }
+        auto flds = fields::make(lyr.get());
+        for (auto limit = static_cast<int>(batch_size);;) {
+            auto rs = select(lyr.get(), flds, limit);
+            if (rs.empty())
+                break;
+            co_yield std::move(rs);
+        }
+    }
+
+    bool copy(db::query const&, db::rowset const&) override { return false; }
+
+    bool exec_batch(db::query const&, db::rowset const&) override
+    {
+        return false;
+    }
+    void cancel() override {}  //< GDAL can't interrupt SQL
+
     void set_autocommit(bool on) override
     {
         gdal::set_autocommit(dataset.get(), on);
@@ -5,6 +5,7 @@
 
 #include <boat/db/meta.hpp>
 #include <boat/gdal/detail/utility.hpp>
+#include <boat/tile.hpp>
 
 namespace boat::gdal {
 
@@ -36,6 +37,16 @@ inline dataset_ptr create(  //
     init();
     auto drv = GDALGetDriverByName(driver);
     boat::check(!!drv, error_or(concat("GDALGetDriverByName ", driver)));
+    auto opts = std::vector<std::string>{};
+    auto list = GDALGetMetadataItem(drv, GDAL_DMD_CREATIONOPTIONLIST, 0);
+    if (list && std::string_view{list}.contains("BLOCKXSIZE"))
+        opts = {"TILED=YES",
+                concat("BLOCKXSIZE=", tile::size),
+                concat("BLOCKYSIZE=", tile::size)};  //< block per tile
+    auto ptrs = opts |
+                std::views::transform([](auto& opt) { return opt.c_str(); }) |
+                std::ranges::to<std::vector<char const*>>();
+    ptrs.push_back(nullptr);
     auto ret = dataset_ptr{GDALCreate(  //
         drv,
         file,
@@ -43,7 +54,7 @@ inline dataset_ptr create(  //
         rast.height,
         static_cast<int>(rast.bands.size()),
         GDALGetDataTypeByName(rast.bands.at(0).type_name.data()),
-        0)};
+        ptrs.data())};
     boat::check(!!ret, error_or(concat("GDALCreate ", file)));
     auto a = std::array{
         rast.xorig,
@@ -8,19 +8,33 @@
 
 namespace boat::gdal {
 
-inline blob get_geometry(OGRFeatureH feat, int index)
+/// reuses the capacity of out, empty if there is no geometry
+inline void get_geometry(OGRFeatureH feat, int index, blob& out)
 {
     auto geom = OGR_F_GetGeomFieldRef(feat, index);
     auto len = geom && !OGR_G_IsEmpty(geom) ? OGR_G_WkbSizeEx(geom) : 0u;
-    auto ret = blob{len, std::byte{}};
+    out.resize(len);
     if (len)
         check(OGR_G_ExportToWkb(
             geom,
             std::endian::native == std::endian::little ? wkbNDR : wkbXDR,
-            reinterpret_cast<unsigned char*>(ret.data())));
+            reinterpret_cast<unsigned char*>(out.data())));
+}
+
+inline blob get_geometry(OGRFeatureH feat, int index)
+{
+    auto ret = blob{};
+    get_geometry(feat, index, ret);
     return ret;
 }
 
+inline void simplify(OGRFeatureH feat, int index, double tolerance)
+{
+    if (auto geom = OGR_F_GetGeomFieldRef(feat, index))
+        if (auto simple = OGR_G_SimplifyPreserveTopology(geom, tolerance))
+            check(OGR_F_SetGeomFieldDirectly(feat, index, simple));
+}
+
 inline void set_geometry(OGRFeatureH feat, int index, blob_view wkb)
 {
     auto geom = OGRGeometryH{};
@@ -84,6 +84,26 @@ struct attribute {
         }
     }
 
+    /// borrows strings and binaries from the feature
+    db::variant_view view(OGRFeatureH feat, db::variant& buf) const
+    {
+        if (!OGR_F_IsFieldNull(feat, index))
+            switch (type) {
+                case OFTString:
+                    return std::string_view{
+                        OGR_F_GetFieldAsString(feat, index)};
+                case OFTBinary: {
+                    int len;
+                    auto ptr = OGR_F_GetFieldAsBinary(feat, index, &len);
+                    return blob_view{as_bytes(ptr), static_cast<size_t>(len)};
+                }
+                default:
+                    break;
+            }
+        buf = read(feat);
+        return db::borrow(buf);
+    }
+
     void write(OGRFeatureH feat, db::variant const& var) const
     {
         if (!var)
@@ -22,6 +22,11 @@ struct fid {
 
     db::variant read(OGRFeatureH feat) const { return OGR_F_GetFID(feat); }
 
+    db::variant_view view(OGRFeatureH feat, db::variant&) const
+    {
+        return static_cast<int64_t>(OGR_F_GetFID(feat));
+    }
+
     void write(OGRFeatureH feat, db::variant const& var) const
     {
         check(OGR_F_SetFID(feat, var ? db::get<int64_t>(var) : OGRNullFID));
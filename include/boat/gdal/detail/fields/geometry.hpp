@@ -41,6 +41,16 @@ struct geometry {
         return wkb.empty() ? db::variant{} : db::variant{std::move(wkb)};
     }
 
+    /// encodes into buf, which keeps its capacity across features
+    db::variant_view view(OGRFeatureH feat, db::variant& buf) const
+    {
+        auto wkb = std::get_if<blob>(&buf);
+        if (!wkb)
+            wkb = &buf.emplace<blob>();
+        get_geometry(feat, index, *wkb);
+        return wkb->empty() ? db::variant_view{} : blob_view{*wkb};
+    }
+
     void write(OGRFeatureH feat, db::variant const& var) const
     {
         if (var)
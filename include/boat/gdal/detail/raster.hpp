@@ -115,6 +115,42 @@ inline void write(  //
         img);
 }
 
+/// decimation factors of the zoom levels below tile::zmax
+inline std::vector<int> overview_factors(int width, int height)
+{
+    return std::views::iota(0, tile::zmax(width, height)) |
+           std::views::reverse | std::views::transform([=](int z) {
+               return tile::scale(width, height, z);
+           }) |
+           std::ranges::to<std::vector>();
+}
+
+/// lets tile reads at low zoom hit the overviews instead of full resolution,
+/// internal for updatable datasets and external .ovr for read-only ones
+inline void build_overviews(  //
+    GDALDatasetH ds,
+    db::raster const& rast,
+    char const* resampling = "average",
+    std::stop_token tok = {})
+{
+    auto factors = overview_factors(rast.width, rast.height);
+    if (factors.empty())
+        return;
+    auto progress = [](double, char const*, void* arg) -> int {
+        return !static_cast<std::stop_token*>(arg)->stop_requested();
+    };
+    auto ec = GDALBuildOverviews(ds,
+                                 resampling,
+                                 static_cast<int>(factors.size()),
+                                 factors.data(),
+                                 0,
+                                 nullptr,
+                                 progress,
+                                 &tok);
+    if (!tok.stop_requested())
+        check(ec);
+}
+
 }  // namespace boat::gdal
 
 #endif  // BOAT_GDAL_RASTER_HPP
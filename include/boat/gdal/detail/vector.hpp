@@ -3,8 +3,9 @@
 #ifndef BOAT_GDAL_VECTOR_HPP
 #define BOAT_GDAL_VECTOR_HPP
 
-#include <boat/db/rowset.hpp>
+#include <boat/db/column_batch.hpp>
 #include <boat/gdal/detail/fields/fields.hpp>
+#include <random>
 #include <stop_token>
 
 namespace boat::gdal {
@@ -98,6 +99,62 @@ db::rowset select(OGRLayerH lyr, range_of<fields::field> auto&& flds, int limit)
     return ret;
 }
 
+/// same as above in columns, payloads are copied from features to arenas
+db::column_batch select_columns(OGRLayerH lyr,
+                                range_of<fields::field> auto&& flds,
+                                int limit)
+{
+    auto ret = db::column_batch{};
+    for (auto& fld : flds)
+        ret.columns.emplace_back().name =
+            std::visit([&](auto& v) { return v.name; }, fld);
+    auto bufs = std::vector<db::variant>(ret.columns.size());
+    for (int i = 0; i < limit; ++i) {
+        auto feat = feature_ptr{OGR_L_GetNextFeature(lyr)};
+        if (!feat)
+            break;
+        for (auto [col, fld, buf] : std::views::zip(ret.columns, flds, bufs))
+            col.push_back(std::visit(
+                [&](auto& v) { return v.view(feat.get(), buf); }, fld));
+    }
+    return ret;
+}
+
+/// reservoir sample of features, geometries are simplified before export
+db::rowset select(OGRLayerH lyr,
+                  range_of<fields::field> auto&& flds,
+                  db::bbox const& rq)
+{
+    auto feats = std::vector<feature_ptr>{};
+    auto gen = std::mt19937{std::random_device()()};
+    auto size = rq.sample > 0 ? std::min(rq.sample, rq.limit) : rq.limit;
+    for (int i = 0; i < rq.limit; ++i) {
+        auto feat = feature_ptr{OGR_L_GetNextFeature(lyr)};
+        if (!feat)
+            break;
+        if (i < size)
+            feats.push_back(std::move(feat));
+        else if (auto pos = std::uniform_int_distribution{0, i}(gen);
+                 pos < size)
+            feats[pos] = std::move(feat);
+    }
+    auto ret = db::rowset{};
+    for (auto& fld : flds)
+        ret.columns.push_back(std::visit([&](auto& v) { return v.name; }, fld));
+    auto vis = overloaded{
+        [&](fields::geometry const& v, OGRFeatureH feat) {
+            if (rq.simplify_tolerance > 0)
+                simplify(feat, v.index, rq.simplify_tolerance);
+            return v.read(feat);
+        },
+        [](auto const& v, OGRFeatureH feat) { return v.read(feat); }};
+    for (auto& feat : feats)
+        for (auto& row = ret.rows.emplace_back(); auto& fld : flds)
+            row.push_back(std::visit(
+                [&](auto& v) { return vis(v, feat.get()); }, fld));
+    return ret;
+}
+
 inline void insert(OGRLayerH lyr, db::rowset const& rs, std::stop_token tok)
 {
     auto flds = fields::make(lyr, rs.columns);
@@ -97,6 +97,31 @@ constexpr auto minmax = []<tagged T>(T const& geom) -> box auto {
     return typename d2_of<T>::box{{xmin, ymin}, {xmax, ymax}};
 };
 
+/// Douglas-Peucker in coordinate units, keeps the geometry type
+inline auto simplify(double max_distance)
+{
+    return overloaded{
+        []<point T>(T const& geom) { return geom; },
+        [=]<single T>(T const& geom)
+            requires(!point<T>)
+        {
+            auto ret = T{};
+            boost::geometry::simplify(geom, ret, max_distance);
+            return ret;
+        },
+        []<multi T>(this auto&& self, T const& geom) {
+            auto ret = T{};
+            for (auto& item : geom)
+                ret.push_back(self(item));
+            return ret;
+        },
+        []<dynamic T>(this auto&& self, T const& var) {
+            return std::visit([&](auto& geom) -> T { return self(geom); },
+                              var);
+        },
+    };
+}
+
 template <box T>
 polygon auto to_polygon(T const& geom)
 {
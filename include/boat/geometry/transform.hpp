@@ -7,6 +7,8 @@
 #include <boat/detail/string.hpp>
 #include <boat/geometry/vocabulary.hpp>
 #include <boost/geometry/strategies/transform/srs_transformer.hpp>
+#include <map>
+#include <mutex>
 #include <optional>
 
 namespace boat::geometry {
@@ -26,9 +28,83 @@ inline auto ortho(geographic::point const& center)
         center.x())};
 }
 
+namespace detail {
+
+inline std::string srs_key(srs::epsg const& crs)
+{
+    return concat("EPSG:", crs.code);
+}
+
+inline std::string srs_key(srs::proj4 const& crs)
+{
+    return crs.str();
+}
+
+/// thread-safe cache keyed by (source, destination), copies share projections
+class transformations {
+public:
+    static constexpr size_t max_size = 64;
+
+    srs::transformation<> get(srs_params auto const& src,
+                              srs_params auto const& dst)
+    {
+        auto key = std::pair{srs_key(src), srs_key(dst)};
+        auto lock = std::lock_guard{guard_};
+        if (auto it = cache_.find(key); it != cache_.end())
+            return it->second;
+        if (cache_.size() >= max_size)
+            cache_.clear();  //< e.g. ortho views are recentred on every pan
+        return cache_.emplace(std::move(key), srs::transformation<>(src, dst))
+            .first->second;
+    }
+
+    static transformations& instance()
+    {
+        static auto ret = transformations{};
+        return ret;
+    }
+
+private:
+    std::mutex guard_;
+    std::map<std::pair<std::string, std::string>, srs::transformation<>>
+        cache_;
+};
+
+void visit_points(tagged auto& geom, auto&& f)
+{
+    overloaded{
+        [&](single auto& g) { boost::geometry::for_each_point(g, f); },
+        [](this auto&& self, multi auto& g) -> void {
+            std::ranges::for_each(g, self);
+        },
+        [](this auto&& self, dynamic auto& var) -> void {
+            std::visit(self, var);
+        },
+    }(geom);
+}
+
+template <multi_point T, class Strategy>
+bool transform_step(T& pts, Strategy const& strategy)
+{
+    namespace bgt = boost::geometry::strategy::transform;
+    if constexpr (specialized<Strategy, bgt::srs_forward_transformer> ||
+                  specialized<Strategy, bgt::srs_inverse_transformer>)
+        return strategy.apply(pts, pts);  //< single pipeline run
+    else
+        return std::ranges::all_of(
+            pts, [&](auto& p) { return strategy.apply(p, p); });
+}
+
+}  // namespace detail
+
+auto transformation(srs_params auto const& src, srs_params auto const& dst)
+{
+    return detail::transformations::instance().get(src, dst);
+}
+
 auto transformation(srs_params auto const& crs)
 {
-    return srs::transformation<>(lonlat, crs);
+    return transformation(lonlat, crs);
 }
 
 template <projection_or_transformation T>
@@ -73,9 +149,26 @@ bool transform(T1 const& geom1, T2& geom2, Strategy const& strategy)
         }}(geom1, geom2);
 }
 
+/// transforms a flat array in place, each strategy applied to it as a whole
+template <multi_point T>
+bool transform_points(T& pts, auto const&... strategies)
+{
+    return (... && detail::transform_step(pts, strategies));
+}
+
 auto transform(auto const&... strategies)
 {
-    return [=]<tagged T>(T g1) {
+    return [=]<tagged T>(T g1) -> std::optional<T> {
+        if constexpr (!point<T> && !box<T>) {
+            auto pts = typename d2_of<T>::multi_point{};
+            detail::visit_points(g1, [&](auto& p) { pts.push_back(p); });
+            if (!pts.empty() && transform_points(pts, strategies...)) {
+                auto it = pts.begin();
+                detail::visit_points(g1, [&](auto& p) { p = *it++; });
+                return g1;
+            }
+            // some parts failed, drop them one by one
+        }
         T g2;
         return (... && (g2 = std::move(g1), transform(g2, g1, strategies)))
                    ? std::optional{std::move(g1)}
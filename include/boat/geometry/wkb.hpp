@@ -7,6 +7,8 @@
 #include <boat/blob.hpp>
 #include <boat/geometry/vocabulary.hpp>
 #include <cstdint>
+#include <cstring>
+#include <span>
 
 namespace boat {
 namespace geometry::detail {
@@ -16,10 +18,34 @@ constexpr auto native = static_cast<uint8_t>(
     std::ranges::find(endians, std::endian::native) - endians.begin());
 static_assert(native < endians.size());
 
+/// copies the coordinate array at once, byte swapped in a vectorizable loop
+void read_points(blob_view& wkb, curve auto& g, std::endian e)
+{
+    using point_type = std::ranges::range_value_t<decltype(g)>;
+    static_assert(std::is_trivially_copyable_v<point_type> &&
+                  sizeof(point_type) == 2 * sizeof(double));
+    auto len = get<uint32_t>(wkb, e) * sizeof(point_type);
+    check(wkb.size() >= len, "out of blob");
+    g.resize(len / sizeof(point_type));
+    auto out = reinterpret_cast<std::byte*>(g.data());
+    if (e == std::endian::native)
+        std::memcpy(out, wkb.data(), len);
+    else
+        for (size_t i{}; i < len; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, wkb.data() + i, sizeof word);
+            word = std::byteswap(word);
+            std::memcpy(out + i, &word, sizeof word);
+        }
+    wkb.remove_prefix(len);
+}
+
 constexpr auto read = overloaded{
     []<class T>(this auto&& self, blob_view& wkb, T& g, std::endian e) -> void {
         if constexpr (point<T>)
             g.x(get<double>(wkb, e)), g.y(get<double>(wkb, e));
+        else if constexpr (curve<T>)
+            read_points(wkb, g, e);
         else
             for (uint32_t i{}, n = get<uint32_t>(wkb, e); i < n; ++i)
                 if constexpr (multi<T>)
@@ -42,36 +68,139 @@ constexpr auto read = overloaded{
         }
     }};
 
+constexpr auto size = overloaded{
+    []<class T>(this auto&& self, T const& g, auto) -> size_t {
+        if constexpr (point<T>)
+            return 2 * sizeof(double);
+        else if constexpr (curve<T>)
+            return sizeof(uint32_t) + g.size() * 2 * sizeof(double);
+        else if constexpr (polygon<T>) {
+            auto ret = sizeof(uint32_t) + self(g.outer(), std::ignore);
+            for (auto& item : g.inners())
+                ret += self(item, std::ignore);
+            return ret;
+        }
+        else {
+            auto ret = sizeof(uint32_t);
+            for (auto& item : g)
+                if constexpr (multi<T>)
+                    ret += self(item);
+                else
+                    ret += self(item, std::ignore);
+            return ret;
+        }
+    },
+    []<class T>(this auto&& self, T const& g) -> size_t {
+        if constexpr (dynamic<T>)
+            return std::visit([&](auto& g) { return self(g); }, g);
+        else
+            return sizeof(uint8_t) + sizeof(uint32_t) + self(g, std::ignore);
+    }};
+
+void put(std::byte*& out, arithmetic auto val)
+{
+    std::memcpy(out, &val, sizeof val);
+    out += sizeof val;
+}
+
+/// copies the coordinate array at once if points are laid out as in wkb
+void write_points(curve auto const& g, std::byte*& out)
+{
+    using point_type = std::ranges::range_value_t<decltype(g)>;
+    put(out, static_cast<uint32_t>(g.size()));
+    if constexpr (std::ranges::contiguous_range<decltype(g)> &&
+                  std::is_trivially_copyable_v<point_type> &&
+                  sizeof(point_type) == 2 * sizeof(double)) {
+        auto len = g.size() * sizeof(point_type);
+        std::memcpy(out, std::ranges::data(g), len);
+        out += len;
+    }
+    else
+        for (auto& p : g)
+            put(out, p.x()), put(out, p.y());
+}
+
+/// the caller reserves detail::size(g) bytes at out
 constexpr auto write = overloaded{
-    []<class T>(this auto&& self, T const& g, blob& wkb, auto) -> void {
+    []<class T>(this auto&& self, T const& g, std::byte*& out, auto) -> void {
         if constexpr (point<T>)
-            wkb << g.x() << g.y();
+            put(out, g.x()), put(out, g.y());
+        else if constexpr (curve<T>)
+            write_points(g, out);
         else if constexpr (polygon<T>) {
-            wkb << static_cast<uint32_t>(1 + g.inners().size());
-            self(g.outer(), wkb, std::ignore);
+            put(out, static_cast<uint32_t>(1 + g.inners().size()));
+            self(g.outer(), out, std::ignore);
             for (auto& item : g.inners())
-                self(item, wkb, std::ignore);
+                self(item, out, std::ignore);
         }
         else {
-            wkb << static_cast<uint32_t>(g.size());
+            put(out, static_cast<uint32_t>(g.size()));
             for (auto& item : g)
                 if constexpr (multi<T>)
-                    self(item, wkb);
+                    self(item, out);
                 else
-                    self(item, wkb, std::ignore);
+                    self(item, out, std::ignore);
         }
     },
-    []<class T>(this auto&& self, T const& g, blob& wkb) -> void {
+    []<class T>(this auto&& self, T const& g, std::byte*& out) -> void {
         if constexpr (dynamic<T>)
-            std::visit([&](auto& g) { self(g, wkb); }, g);
+            std::visit([&](auto& g) { self(g, out); }, g);
         else {
-            wkb << native << static_cast<uint32_t>(variant_index_v<T> + 1);
-            self(g, wkb, std::ignore);
+            put(out, native);
+            put(out, static_cast<uint32_t>(variant_index_v<T> + 1));
+            self(g, out, std::ignore);
         }
     }};
 
 }  // namespace geometry::detail
 
+namespace geometry {
+
+/// bytes taken by the encoding, to preallocate output
+size_t wkb_size(ogc99 auto const& geom)
+{
+    return detail::size(geom);
+}
+
+/// encodes into the front of out, returns the rest of it
+std::span<std::byte> write(ogc99 auto const& geom, std::span<std::byte> out)
+{
+    check(out.size() >= wkb_size(geom), "out of buffer");
+    auto ptr = out.data();
+    detail::write(geom, ptr);
+    return out.subspan(ptr - out.data());
+}
+
+/// many geometries encoded into a single allocation
+struct wkb_arena {
+    blob bytes;
+    std::vector<size_t> offsets;  //< end of each geometry
+
+    size_t size() const { return offsets.size(); }
+
+    blob_view operator[](size_t i) const
+    {
+        auto pos = i ? offsets[i - 1] : 0;
+        return {bytes.data() + pos, offsets[i] - pos};
+    }
+};
+
+wkb_arena to_wkb_arena(std::ranges::forward_range auto&& geoms)
+{
+    auto ret = wkb_arena{};
+    auto len = 0uz;
+    for (auto&& geom : geoms)
+        ret.offsets.push_back(len += wkb_size(geom));
+    ret.bytes.resize_and_overwrite(len, [&](std::byte* ptr, size_t n) {
+        for (auto&& geom : geoms)
+            detail::write(geom, ptr);
+        return n;
+    });
+    return ret;
+}
+
+}  // namespace geometry
+
 blob_view& operator>>(blob_view& wkb, geometry::ogc99 auto& geom)
 {
     geometry::detail::read(wkb, geom);
@@ -80,7 +209,13 @@ blob_view& operator>>(blob_view& wkb, geometry::ogc99 auto& geom)
 
 blob& operator<<(blob& wkb, geometry::ogc99 auto const& geom)
 {
-    geometry::detail::write(geom, wkb);
+    auto pos = wkb.size();
+    wkb.resize_and_overwrite(
+        pos + geometry::wkb_size(geom), [&](std::byte* ptr, size_t n) {
+            ptr += pos;
+            geometry::detail::write(geom, ptr);
+            return n;
+        });
     return wkb;
 }
 
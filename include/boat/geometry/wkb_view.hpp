@@ -0,0 +1,255 @@
+// Andrew Naplavkov
+
+#ifndef BOAT_GEOMETRY_WKB_VIEW_HPP
+#define BOAT_GEOMETRY_WKB_VIEW_HPP
+
+#include <boat/geometry/wkb.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+namespace boat::geometry {
+namespace detail {
+
+/// bytes taken by the geometry at the front of wkb
+inline size_t wkb_extent(blob_view wkb)
+{
+    auto in = wkb;
+    auto skip = [&](size_t len) {
+        check(in.size() >= len, "out of blob");
+        in.remove_prefix(len);
+    };
+    auto e = endians.at(get<uint8_t>(in));
+    switch (auto type = get<uint32_t>(in, e)) {
+        case 1:
+            skip(2 * sizeof(double));
+            break;
+        case 2:
+            skip(get<uint32_t>(in, e) * 2 * sizeof(double));
+            break;
+        case 3:
+            for (auto n = get<uint32_t>(in, e); n--;)
+                skip(get<uint32_t>(in, e) * 2 * sizeof(double));
+            break;
+        default:
+            check(type >= 4 && type <= 7, "wkb");
+            for (auto n = get<uint32_t>(in, e); n--;)
+                skip(wkb_extent(in));
+    }
+    return wkb.size() - in.size();
+}
+
+}  // namespace detail
+
+/// coordinates read in place, adapted as a Boost.Geometry linestring
+template <class CoordSys>
+class wkb_points {
+    static constexpr std::ptrdiff_t stride = 2 * sizeof(double);
+
+    blob_view bytes_;
+    std::endian e_;
+
+public:
+    using point_type = d2<CoordSys>::point;
+
+    class iterator
+        : public boost::iterator_facade<iterator,
+                                        point_type,
+                                        boost::random_access_traversal_tag,
+                                        point_type> {
+        friend boost::iterator_core_access;
+        std::byte const* ptr_{};
+        std::endian e_{};
+
+        point_type dereference() const
+        {
+            auto in = blob_view{ptr_, stride};
+            auto x = get<double>(in, e_);
+            return {x, get<double>(in, e_)};
+        }
+
+        bool equal(iterator const& other) const { return ptr_ == other.ptr_; }
+        void increment() { ptr_ += stride; }
+        void decrement() { ptr_ -= stride; }
+        void advance(std::ptrdiff_t n) { ptr_ += n * stride; }
+
+        std::ptrdiff_t distance_to(iterator const& other) const
+        {
+            return (other.ptr_ - ptr_) / stride;
+        }
+
+    public:
+        iterator() = default;
+        iterator(std::byte const* ptr, std::endian e) : ptr_{ptr}, e_{e} {}
+    };
+
+    using const_iterator = iterator;
+
+    wkb_points() = default;
+    wkb_points(blob_view bytes, std::endian e) : bytes_{bytes}, e_{e} {}
+
+    static wkb_points read(blob_view& wkb, std::endian e)
+    {
+        auto len = get<uint32_t>(wkb, e) * stride;
+        check(wkb.size() >= len, "out of blob");
+        auto ret = wkb_points{{wkb.data(), len}, e};
+        wkb.remove_prefix(len);
+        return ret;
+    }
+
+    iterator begin() const { return {bytes_.data(), e_}; }
+    iterator end() const { return {bytes_.data() + bytes_.size(), e_}; }
+    size_t size() const { return bytes_.size() / stride; }
+    bool empty() const { return bytes_.empty(); }
+};
+
+/// rings or parts, each one parsed when dereferenced
+template <class T>
+class wkb_sequence {
+    blob_view items_;
+    std::endian e_;
+    uint32_t size_;
+
+public:
+    class iterator : public boost::iterator_facade<iterator,
+                                                   T,
+                                                   boost::forward_traversal_tag,
+                                                   T> {
+        friend boost::iterator_core_access;
+        blob_view rest_;
+        std::endian e_{};
+        uint32_t pos_{};
+
+        T dereference() const
+        {
+            auto in = rest_;
+            return T::read(in, e_);
+        }
+
+        bool equal(iterator const& other) const { return pos_ == other.pos_; }
+
+        void increment()
+        {
+            T::read(rest_, e_);
+            ++pos_;
+        }
+
+    public:
+        iterator() = default;
+        iterator(blob_view rest, std::endian e, uint32_t pos)
+            : rest_{rest}, e_{e}, pos_{pos}
+        {
+        }
+    };
+
+    using const_iterator = iterator;
+
+    wkb_sequence(blob_view items, std::endian e, uint32_t size)
+        : items_{items}, e_{e}, size_{size}
+    {
+    }
+
+    iterator begin() const { return {items_, e_, 0}; }
+    iterator end() const { return {{}, e_, size_}; }
+    size_t size() const { return size_; }
+    bool empty() const { return !size_; }
+};
+
+/// lazy access to wkb without materializing Boost.Geometry models
+template <class CoordSys = boost::geometry::cs::cartesian>
+class wkb_view {
+    blob_view wkb_;
+
+    auto header() const
+    {
+        auto in = wkb_;
+        auto e = detail::endians.at(get<uint8_t>(in));
+        auto i = get<uint32_t>(in, e) - 1;
+        return std::tuple{in, e, i};
+    }
+
+public:
+    explicit wkb_view(blob_view wkb) : wkb_{wkb} {}
+
+    static wkb_view read(blob_view& wkb, std::endian)
+    {
+        auto ret = wkb_view{{wkb.data(), detail::wkb_extent(wkb)}};
+        wkb.remove_prefix(ret.wkb_.size());
+        return ret;
+    }
+
+    /// alternative of d2<CoordSys>::variant
+    size_t index() const { return std::get<2>(header()); }
+
+    /// of a point or a linestring
+    wkb_points<CoordSys> points() const
+    {
+        auto [in, e, i] = header();
+        if (i == variant_index_v<typename d2<CoordSys>::point>) {
+            check(in.size() >= 2 * sizeof(double), "out of blob");
+            return {{in.data(), 2 * sizeof(double)}, e};
+        }
+        check(i == variant_index_v<typename d2<CoordSys>::linestring>, "wkb");
+        return wkb_points<CoordSys>::read(in, e);
+    }
+
+    /// of a polygon, the exterior one first
+    wkb_sequence<wkb_points<CoordSys>> rings() const
+    {
+        auto [in, e, i] = header();
+        check(i == variant_index_v<typename d2<CoordSys>::polygon>, "wkb");
+        auto n = get<uint32_t>(in, e);
+        return {in, e, n};
+    }
+
+    /// of a multi geometry or a geometry collection
+    wkb_sequence<wkb_view> parts() const
+    {
+        auto [in, e, i] = header();
+        check(i >= variant_index_v<typename d2<CoordSys>::multi_point>, "wkb");
+        auto n = get<uint32_t>(in, e);
+        return {in, e, n};
+    }
+};
+
+template <class CoordSys>
+void for_each_point(wkb_view<CoordSys> const& g, auto&& f)
+{
+    using d2 = geometry::d2<CoordSys>;
+    switch (g.index()) {
+        case variant_index_v<typename d2::point>:
+        case variant_index_v<typename d2::linestring>:
+            std::ranges::for_each(g.points(), f);
+            break;
+        case variant_index_v<typename d2::polygon>:
+            for (auto ring : g.rings())
+                std::ranges::for_each(ring, f);
+            break;
+        default:
+            for (auto part : g.parts())
+                for_each_point(part, f);
+    }
+}
+
+template <class CoordSys>
+d2<CoordSys>::box envelope(wkb_view<CoordSys> const& g)
+{
+    double xmin = INFINITY;
+    double ymin = INFINITY;
+    double xmax = -INFINITY;
+    double ymax = -INFINITY;
+    for_each_point(g, [&](point auto const& p) {
+        xmin = std::min<>(xmin, p.x());
+        ymin = std::min<>(ymin, p.y());
+        xmax = std::max<>(xmax, p.x());
+        ymax = std::max<>(ymax, p.y());
+    });
+    return {{xmin, ymin}, {xmax, ymax}};
+}
+
+}  // namespace boat::geometry
+
+template <class CoordSys>
+struct boost::geometry::traits::tag<boat::geometry::wkb_points<CoordSys>> {
+    using type = linestring_tag;
+};
+
+#endif  // BOAT_GEOMETRY_WKB_VIEW_HPP
@@ -13,7 +13,7 @@ auto bidirectional(  //
     geometry::matrix const& affine2,
     geometry::srs_params auto const& crs2)
 {
-    auto tf = geometry::srs::transformation<>(crs1, crs2);
+    auto tf = geometry::transformation(crs1, crs2);
     return std::pair{
         geometry::transform(  //
             geometry::mat_forward(affine1),
@@ -26,6 +26,67 @@ auto bidirectional(  //
     };
 }
 
+/// source pixels of the destination rect, NaN where undefined, exact at the
+/// corners of cells and bilinear inside, cells are split while their center
+/// is off by more than max_error pixels, as in GDAL's approximate transformer
+void approximate(  //
+    auto const& inv,
+    double x,
+    double y,
+    int width,
+    int height,
+    std::span<geometry::geographic::point> out,
+    int cell = 16,
+    double max_error = .125)
+{
+    using point = geometry::geographic::point;
+    auto exact = [&](double col, double row) {
+        return inv(point(x + col, y + row));
+    };
+    auto lerp = [](point const& a, point const& b, double t) {
+        return point(std::lerp(a.x(), b.x(), t), std::lerp(a.y(), b.y(), t));
+    };
+    auto fill = [&](this auto&& self, int c0, int r0, int w, int h) -> void {
+        if (w * h <= 4) {
+            for (auto r = r0; r < r0 + h; ++r)
+                for (auto c = c0; c < c0 + w; ++c)
+                    out[r * width + c] =
+                        exact(c, r).value_or(point(NAN, NAN));
+            return;
+        }
+        auto a = exact(c0, r0), b = exact(c0 + w, r0);
+        auto c = exact(c0, r0 + h), d = exact(c0 + w, r0 + h);
+        auto bilinear = [&](double u, double v) {
+            return lerp(lerp(*a, *b, u), lerp(*c, *d, u), v);
+        };
+        auto m = exact(c0 + w * .5, r0 + h * .5);
+        if (a && b && c && d && m) {
+            auto p = bilinear(.5, .5);
+            if (std::hypot(p.x() - m->x(), p.y() - m->y()) <= max_error) {
+                for (auto r = 0; r < h; ++r)
+                    for (auto col = 0; col < w; ++col)
+                        out[(r0 + r) * width + c0 + col] =
+                            bilinear(col * 1. / w, r * 1. / h);
+                return;
+            }
+        }
+        auto w1 = (w + 1) / 2, h1 = (h + 1) / 2;
+        self(c0, r0, w1, h1);
+        if (w > w1)
+            self(c0 + w1, r0, w - w1, h1);
+        if (h > h1)
+            self(c0, r0 + h1, w1, h - h1);
+        if (w > w1 && h > h1)
+            self(c0 + w1, r0 + h1, w - w1, h - h1);
+    };
+    for (auto r0 = 0; r0 < height; r0 += cell)
+        for (auto c0 = 0; c0 < width; c0 += cell)
+            fill(c0,
+                 r0,
+                 std::min<>(cell, width - c0),
+                 std::min<>(cell, height - r0));
+}
+
 auto boxes(  //
     geometry::geographic::grid const& grid,
     geometry::srs_params auto const& crs)
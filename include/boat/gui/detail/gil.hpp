@@ -8,14 +8,49 @@
 
 namespace boat::gui {
 
-auto get_pixel(specialized<boost::gil::image_view> auto image)
+enum class filter { nearest, bilinear };
+
+/// samples a row of source coordinates, NaN or outside ones are transparent
+inline void resample(  //
+    boost::gil::rgba8c_view_t in,
+    std::span<geometry::geographic::point const> src,
+    boost::gil::rgba8_pixel_t* out,
+    filter f = filter::nearest)
 {
-    return [=](geometry::point auto const& pixel) {
-        auto x = pixel.x(), y = pixel.y();
-        return x >= 0 && x < image.width() && y >= 0 && y < image.height()
-                   ? std::optional{image(x, y)}
-                   : std::nullopt;
+    auto w = static_cast<double>(in.width());
+    auto h = static_cast<double>(in.height());
+    auto inside = [&](auto& p) {
+        return p.x() >= 0. && p.x() < w && p.y() >= 0. && p.y() < h;
+    };
+    if (f == filter::nearest) {
+        for (auto& p : src)
+            *out++ = inside(p) ? in.row_begin(static_cast<ptrdiff_t>(p.y()))
+                                     [static_cast<ptrdiff_t>(p.x())]
+                               : boost::gil::rgba8_pixel_t{};
+        return;
+    }
+    auto clamp = [](double v, ptrdiff_t n) {
+        return std::clamp<ptrdiff_t>(static_cast<ptrdiff_t>(v), 0, n - 1);
     };
+    for (auto& p : src) {
+        if (!inside(p)) {
+            *out++ = {};
+            continue;
+        }
+        auto x = p.x() - .5, y = p.y() - .5;
+        auto fx = x - std::floor(x), fy = y - std::floor(y);
+        auto x0 = clamp(std::floor(x), in.width());
+        auto x1 = clamp(std::floor(x) + 1., in.width());
+        auto r0 = in.row_begin(clamp(std::floor(y), in.height()));
+        auto r1 = in.row_begin(clamp(std::floor(y) + 1., in.height()));
+        for (int c{}; c < 4; ++c) {
+            auto top = std::lerp(r0[x0][c] * 1., r0[x1][c] * 1., fx);
+            auto bottom = std::lerp(r1[x0][c] * 1., r1[x1][c] * 1., fx);
+            (*out)[c] =
+                static_cast<uint8_t>(std::lerp(top, bottom, fy) + .5);
+        }
+        ++out;
+    }
 }
 
 }  // namespace boat::gui
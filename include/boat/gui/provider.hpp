@@ -7,8 +7,10 @@
 #include <boat/gui/caches/cache.hpp>
 #include <boat/gui/detail/geometry.hpp>
 #include <boat/gui/detail/tile.hpp>
+#include <boat/gui/pyramid.hpp>
 #include <boat/gui/variant.hpp>
 #include <random>
+#include <thread>
 
 namespace boat::gui {
 
@@ -18,6 +20,15 @@ struct provider {
     std::shared_ptr<caches::cache> cache;
     size_t key;
     geometry::geographic::grid grid;
+    std::stop_token token;  //< cancels running queries
+
+    /// leases a separate connection for the duration of a bbox query,
+    /// so that providers of the same address share them, if any
+    std::function<std::shared_ptr<db::catalog>()> reader;
+    size_t readers = std::thread::hardware_concurrency();
+
+    /// serves boxes at the closest simplified level, if built
+    std::shared_ptr<pyramid> lod;
 
     std::generator<variant> variants()
     {
@@ -39,34 +50,125 @@ private:
         check(it != tbl.columns.end(), col);
         auto crs = geometry::srs::epsg(it->epsg);
         auto voids = bgi::rtree<geometry::cartesian::box, bgi::rstar<4>>{};
-        auto gen = std::mt19937{std::random_device()()};
-        for (auto& box : boxes(grid, crs)) {
-            if (bgi::qbegin(voids, bgi::contains(box)) != bgi::qend(voids))
-                continue;
+        auto inv = geometry::transform(
+            geometry::srs_inverse(geometry::transformation(crs)));
+        auto decode = [&](blob_view wkb) {
+            auto ret = geometry::geographic::variant{};
+            wkb >> ret;
+            return inv(ret);
+        };
+        using sample = std::vector<decltype(decode({}))>;  //< reservoir
+        constexpr auto max_sample = 128uz;
+        auto key_of = [&](geometry::cartesian::box const& box) {
             auto a = box.min_corner(), b = box.max_corner();
-            auto geoms = get_or_invoke(
-                cache.get(), std::tuple{key, a.x(), a.y(), b.x(), b.y()}, [&] {
-                    auto rs = catalog().select(
-                        tbl,
-                        db::bbox{{col}, col, a.x(), a.y(), b.x(), b.y(), 4096});
-                    auto wkb = std::vector<blob>{};
-                    std::ranges::sample(
-                        rs | db::view<blob>, std::back_inserter(wkb), 128, gen);
-                    auto inv = geometry::transform(
-                        geometry::srs_inverse(geometry::transformation(crs)));
-                    auto ret = geometry::geographic::geometry_collection{};
-                    for (blob_view item : wkb) {
-                        auto g1 = geometry::geographic::variant{};
-                        item >> g1;
-                        if (auto g2 = inv(g1))
-                            ret.push_back(*g2);
-                    }
-                    return ret;
+            return std::tuple{key, a.x(), a.y(), b.x(), b.y()};
+        };
+        auto visit = [&](std::span<sample> samples, auto&& source) {
+            auto gen = std::mt19937{std::random_device()()};
+            auto seen = std::vector<size_t>(samples.size());
+            auto on_row = [&](size_t i, std::span<db::variant_view const> row) {
+                auto wkb = std::get_if<blob_view>(&row.front());
+                if (!wkb)
+                    return;
+                auto pos = seen[i]++;
+                if (pos >= max_sample)
+                    pos = std::uniform_int_distribution<size_t>{0, pos}(gen);
+                if (pos < samples[i].size())
+                    samples[i][pos] = decode(*wkb);
+                else if (pos < max_sample)
+                    samples[i].push_back(decode(*wkb));
+            };
+            source(on_row);
+        };
+        auto fetch = [&](db::catalog& cat, std::span<db::bbox const> rqs) {
+            return [&, ptr = &cat, rqs](db::row_visitor const& f) {
+                ptr->visit(tbl, rqs | std::ranges::to<std::vector>(), f, token);
+            };
+        };
+        for (auto chunk : boxes(grid, crs) | std::views::chunk(32)) {
+            using cached =
+                std::tuple<geometry::cartesian::box, std::any, bool>;
+            auto todo = std::vector<cached>{};
+            auto rqs = std::vector<db::bbox>{};
+            auto coarse = std::vector<std::pair<int64_t, db::bbox>>{};
+            for (auto& box : chunk) {
+                if (bgi::qbegin(voids, bgi::contains(box)) != bgi::qend(voids))
+                    continue;
+                auto any = cache ? cache->get(key_of(box)) : std::any{};
+                auto lvl = std::optional<pyramid::level>{};
+                if (!any.has_value()) {
+                    auto a = box.min_corner(), b = box.max_corner();
+                    auto rq = db::bbox{
+                        .select_list{col},
+                        .layer_column = col,
+                        .xmin = a.x(),
+                        .ymin = a.y(),
+                        .xmax = b.x(),
+                        .ymax = b.y(),
+                        .limit = 4096,
+                        .sample = int(max_sample),
+                        .simplify_tolerance = (b.x() - a.x()) / tile::size,
+                    };
+                    if (lod)
+                        lvl = lod->find(rq.simplify_tolerance);
+                    if (lvl)
+                        coarse.emplace_back(lvl->id, std::move(rq));
+                    else
+                        rqs.push_back(std::move(rq));
+                }
+                todo.emplace_back(box, std::move(any), !!lvl);
+            }
+            auto samples = std::vector<sample>(rqs.size());
+            auto coarse_samples = std::vector<sample>(coarse.size());
+            if (!coarse.empty())
+                visit(coarse_samples, [&](db::row_visitor const& f) {
+                    lod->visit(coarse, f, token);
                 });
-            if (geoms.empty())
-                voids.insert(box);
-            else
-                co_yield std::move(geoms);
+            if (!reader || readers < 2 || rqs.size() < 2) {
+                if (!rqs.empty())
+                    visit(samples, fetch(catalog(), rqs));
+            }
+            else {
+                auto n = std::min(readers, rqs.size());
+                auto errs = std::vector<std::exception_ptr>(n);
+                auto workers = std::vector<std::jthread>{};
+                for (size_t w{}; w < n; ++w)
+                    workers.emplace_back([&, w] {
+                        auto first = rqs.size() * w / n;
+                        auto count = rqs.size() * (w + 1) / n - first;
+                        try {
+                            auto cat = reader();
+                            visit(std::span{samples}.subspan(first, count),
+                                  fetch(*cat,
+                                        std::span{rqs}.subspan(first, count)));
+                        }
+                        catch (...) {
+                            errs[w] = std::current_exception();
+                        }
+                    });
+                workers.clear();  //< join
+                for (auto& err : errs)
+                    if (err)
+                        std::rethrow_exception(err);
+            }
+            auto next = samples.begin();
+            auto next_coarse = coarse_samples.begin();
+            for (auto& [box, any, from_lod] : todo) {
+                auto geoms = geometry::geographic::geometry_collection{};
+                if (any.has_value())
+                    geoms = std::any_cast<decltype(geoms)>(std::move(any));
+                else {
+                    for (auto& item : from_lod ? *next_coarse++ : *next++)
+                        if (item)
+                            geoms.push_back(*item);
+                    if (cache)
+                        cache->put(key_of(box), geoms);
+                }
+                if (geoms.empty())
+                    voids.insert(box);
+                else
+                    co_yield std::move(geoms);
+            }
         }
     }
 
@@ -92,7 +194,7 @@ private:
             co_yield {
                 std::move(rgba), affine * t.affine(r.width, r.height), crs};
         }
-        for (auto [t, img] : catalog().read(r, std::move(uncached))) {
+        for (auto [t, img] : catalog().read(r, std::move(uncached), token)) {
             auto rgba = gil::to<boost::gil::rgba8_image_t>(const_view(img));
             if (cache)
                 cache->put(std::tuple{key, t}, rgba);
@@ -0,0 +1,250 @@
+// Andrew Naplavkov
+
+#ifndef BOAT_GUI_PYRAMID_HPP
+#define BOAT_GUI_PYRAMID_HPP
+
+#include <boat/db/catalog.hpp>
+#include <boat/db/reflection.hpp>
+#include <boat/geometry/wkb_view.hpp>
+#include <boat/tile.hpp>
+#include <mutex>
+
+namespace boat::gui {
+
+/// simplified copies of a vector layer, one table per level of detail
+class pyramid {
+public:
+    struct level {
+        int64_t id;
+        double tolerance;  //< in layer units
+    };
+
+    /// source summary recorded by build to tell if it has changed since
+    struct stamp {
+        int64_t rows;
+        double xmin;
+        double ymin;
+        double xmax;
+        double ymax;
+
+        bool operator==(stamp const&) const = default;
+    };
+
+    static constexpr auto column_name = "geom";
+    static constexpr auto table_name = "lod";
+    static constexpr auto stamp_name = "lod_stamp";
+    static constexpr auto max_levels = 32;
+
+    /// sidecar catalog, e.g. a spatialite file next to the layer source
+    explicit pyramid(std::unique_ptr<db::catalog> sidecar)
+        : cat_{std::move(sidecar)}
+    {
+        try {
+            auto tbl = cat_->get_table({}, table_name);
+            if (tbl.columns.empty())
+                return;
+            auto page = db::page{
+                .select_list = boost::pfr::names_as_array<level>() |
+                               std::ranges::to<std::vector<std::string>>(),
+                .limit = max_levels};
+            for (auto lvl : cat_->select(tbl, page) | db::view<level>) {
+                tables_.push_back(cat_->get_table({}, name(lvl.id)));
+                levels_.push_back(lvl);
+            }
+            page.select_list = boost::pfr::names_as_array<stamp>() |
+                               std::ranges::to<std::vector<std::string>>();
+            page.limit = 1;
+            for (auto st : cat_->select(cat_->get_table({}, stamp_name), page) |
+                               db::view<stamp>)
+                stamp_ = st;
+        }
+        catch (std::exception const&) {
+            levels_.clear();
+            tables_.clear();
+            stamp_.reset();
+        }
+    }
+
+    /// false if the source has changed since the levels were built
+    bool fresh(db::catalog& src,
+               db::table const& tbl,
+               std::string_view layer_column,
+               std::stop_token tok = {})
+    {
+        auto cur = survey(src, tbl, layer_column, tok);
+        auto lock = std::lock_guard{guard_};
+        return cur && stamp_ == cur;
+    }
+
+    std::vector<level> levels()
+    {
+        auto lock = std::lock_guard{guard_};
+        return levels_;
+    }
+
+    /// replaces levels, each one twice as detailed as the previous,
+    /// the current ones are served until the new ones are complete
+    void build(db::catalog& src,
+               db::table const& tbl,
+               std::string_view layer_column,
+               int num_levels = 8,
+               std::stop_token tok = {})
+    {
+        check(num_levels > 0 && num_levels <= max_levels, "pyramid levels");
+        auto build_lock = std::lock_guard{build_guard_};
+        auto st = survey(src, tbl, layer_column, tok);
+        if (!st)
+            return;
+        auto size = std::max<>(st->xmax - st->xmin, st->ymax - st->ymin);
+        check(st->rows && std::isfinite(size), "empty layer");
+        auto it = std::ranges::find(
+            tbl.columns, layer_column, &db::column::column_name);
+        auto select_list = std::vector{it->column_name};
+        auto col = *it;
+        col.column_name = column_name;
+        auto lvls = std::vector<level>{};
+        auto tbls = std::vector<db::table>{};
+        auto lock = std::unique_lock{guard_};
+        auto first = std::ranges::fold_left(
+            levels_, int64_t{}, [](int64_t id, level const& lvl) {
+                return std::max<>(id, lvl.id + 1);
+            });  //< ids of the served levels stay valid
+        for (int i{}; i < num_levels; ++i) {
+            auto& lvl = lvls.emplace_back(first + i,
+                                          std::ldexp(size / tile::size, -i));
+            cat_->drop({}, name(lvl.id));  //< left by a cancelled build
+            tbls.push_back(cat_->create({
+                .table_name = name(lvl.id),
+                .columns{col},
+                .index_keys{{.index_name{"rtree"}, .column_name{column_name}}},
+            }));
+        }
+        cat_->set_autocommit(false);
+        auto _ = finally{[&] {
+            if (!lock)
+                lock.lock();
+            cat_->set_autocommit(true);
+        }};
+        lock.unlock();
+        for (auto&& rs : src.scan(tbl, select_list, batch_size)) {
+            if (tok.stop_requested())
+                return;  //< tables are dropped by the next build
+            auto geoms = std::vector<geometry::cartesian::variant>{};
+            for (auto& row : rs)
+                if (auto wkb = std::get_if<blob>(&row[0]))
+                    blob_view{*wkb} >> geoms.emplace_back();
+            auto outs = std::vector<db::column_batch>{};
+            for (auto& lvl : lvls) {
+                auto simple = geoms |
+                              std::views::transform(
+                                  geometry::simplify(lvl.tolerance)) |
+                              std::ranges::to<std::vector>();
+                outs.push_back({.columns{db::to_column(
+                    column_name, geometry::to_wkb_arena(simple))}});
+            }
+            auto batch_lock = std::lock_guard{guard_};
+            for (auto [lod, out] : std::views::zip(tbls, outs))
+                cat_->insert_columns(lod, out);
+            cat_->commit();
+        }
+        lock.lock();
+        for (auto& lvl : levels_)
+            cat_->drop({}, name(lvl.id));
+        cat_->drop({}, table_name);
+        auto meta = db::to_table<level>();
+        meta.table_name = table_name;
+        cat_->insert(cat_->create(meta), db::to_rowset(lvls));
+        cat_->drop({}, stamp_name);
+        meta = db::to_table<stamp>();
+        meta.table_name = stamp_name;
+        cat_->insert(cat_->create(meta), db::to_rowset(std::array{*st}));
+        cat_->commit();
+        levels_ = std::move(lvls);
+        tables_ = std::move(tbls);
+        stamp_ = st;
+    }
+
+    /// the coarsest level that is not visibly coarser than the tolerance
+    std::optional<level> find(double tolerance)
+    {
+        auto lock = std::lock_guard{guard_};
+        for (auto& lvl : levels_)
+            if (lvl.tolerance <= tolerance)
+                return lvl;
+        return std::nullopt;
+    }
+
+    /// bbox requests paired with level ids, rows are reported by pair index
+    void visit(std::span<std::pair<int64_t, db::bbox> const> rqs,
+               db::row_visitor const& f,
+               std::stop_token tok = {})
+    {
+        auto lock = std::lock_guard{guard_};
+        for (auto [lvl, lod] : std::views::zip(levels_, tables_)) {
+            auto idx = std::vector<size_t>{};
+            auto bbs = std::vector<db::bbox>{};
+            for (auto [i, rq] : std::views::enumerate(rqs)) {
+                if (rq.first != lvl.id)
+                    continue;
+                idx.push_back(i);
+                auto& bb = bbs.emplace_back(rq.second);
+                bb.select_list = {column_name};
+                bb.layer_column = column_name;
+                bb.simplify_tolerance = 0;
+            }
+            if (!bbs.empty())
+                cat_->visit(
+                    lod,
+                    std::move(bbs),
+                    [&](size_t i, auto row) { f(idx[i], row); },
+                    tok);
+        }
+    }
+
+private:
+    static constexpr size_t batch_size = 1'000;
+
+    std::mutex build_guard_;
+    std::mutex guard_;  //< of the sidecar and served levels
+    std::unique_ptr<db::catalog> cat_;
+    std::vector<level> levels_;      //< coarsest first
+    std::vector<db::table> tables_;  //< by level
+    std::optional<stamp> stamp_;     //< of the source the levels are built of
+
+    /// rows with geometries and their extent, none if stopped
+    static std::optional<stamp> survey(db::catalog& src,
+                                       db::table const& tbl,
+                                       std::string_view layer_column,
+                                       std::stop_token tok)
+    {
+        auto it = std::ranges::find(
+            tbl.columns, layer_column, &db::column::column_name);
+        check(it != tbl.columns.end(), layer_column);
+        auto ret = stamp{.rows = 0,
+                         .xmin = INFINITY,
+                         .ymin = INFINITY,
+                         .xmax = -INFINITY,
+                         .ymax = -INFINITY};
+        for (auto&& rs : src.scan(tbl, {it->column_name}, batch_size))
+            for (auto& row : rs) {
+                if (tok.stop_requested())
+                    return std::nullopt;
+                auto wkb = std::get_if<blob>(&row[0]);
+                if (!wkb)
+                    continue;
+                auto mbr = geometry::envelope(geometry::wkb_view{*wkb});
+                ++ret.rows;
+                ret.xmin = std::min<>(ret.xmin, mbr.min_corner().x());
+                ret.ymin = std::min<>(ret.ymin, mbr.min_corner().y());
+                ret.xmax = std::max<>(ret.xmax, mbr.max_corner().x());
+                ret.ymax = std::max<>(ret.ymax, mbr.max_corner().y());
+            }
+        return ret;
+    }
+
+    static std::string name(int64_t id) { return concat(table_name, "_", id); }
+};
+
+}  // namespace boat::gui
+
+#endif  // BOAT_GUI_PYRAMID_HPP
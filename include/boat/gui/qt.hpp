@@ -48,7 +48,8 @@ void draw_image(  //
     geometry::srs_params auto&& in_crs,
     QPainter& out,
     geometry::matrix const& out_affine,
-    geometry::srs_params auto&& out_crs)
+    geometry::srs_params auto&& out_crs,
+    filter f = filter::nearest)
 {
     auto [fwd, inv] = bidirectional(in_affine, in_crs, out_affine, out_crs);
     auto mbr =
@@ -60,19 +61,18 @@ void draw_image(  //
     if (!mbr || mbr->isEmpty())
         return;
     auto img = QImage{mbr->size(), QImage::Format_RGBA8888};
-    auto ys = std::views::iota(0, img.height());
-    auto pixel = get_pixel(in);
-    std::for_each(policy, ys.begin(), ys.end(), [&](int y) {
-        auto ln = reinterpret_cast<uint8_t*>(img.scanLine(y));
-        for (int x{}; x < img.width(); ++x) {
-            auto px =
-                inv(geometry::geographic::point(x + mbr->x(), y + mbr->y()))
-                    .and_then(pixel);
-            if (px)
-                *reinterpret_cast<boost::gil::rgba8_pixel_t*>(ln + x * 4) = *px;
-            else
-                std::fill_n(ln + x * 4, 4, 0);
-        }
+    constexpr auto band = 16;
+    auto bands = std::views::iota(0, (img.height() + band - 1) / band);
+    std::for_each(policy, bands.begin(), bands.end(), [&](int i) {
+        auto y0 = i * band, h = std::min<>(band, img.height() - y0);
+        auto src = std::vector<geometry::geographic::point>(h * img.width());
+        approximate(inv, mbr->x(), mbr->y() + y0, img.width(), h, src);
+        for (int y{}; y < h; ++y)
+            resample(in,
+                     std::span{src}.subspan(y * img.width(), img.width()),
+                     reinterpret_cast<boost::gil::rgba8_pixel_t*>(
+                         img.scanLine(y0 + y)),
+                     f);
     });
     out.drawImage(mbr->topLeft(), img);
 }
@@ -49,7 +49,8 @@ void draw_image(  //
     geometry::srs_params auto&& in_crs,
     wxGraphicsContext& out,
     geometry::matrix const& out_affine,
-    geometry::srs_params auto&& out_crs)
+    geometry::srs_params auto&& out_crs,
+    filter f = filter::nearest)
 {
     auto [fwd, inv] = bidirectional(in_affine, in_crs, out_affine, out_crs);
     auto intersect = [&](geometry::box auto&& v) {
@@ -68,24 +69,26 @@ void draw_image(  //
         return;
     auto img = wxImage{mbr->GetSize()};
     img.InitAlpha();
-    auto ys = std::views::iota(0, img.GetHeight());
-    auto pixel = get_pixel(in);
-    std::for_each(policy, ys.begin(), ys.end(), [&](int y) {
-        auto d = y * img.GetWidth();
-        auto rgb = reinterpret_cast<wxImage::RGBValue*>(img.GetData()) + d;
-        auto alpha = img.GetAlpha() + d;
-        for (int x{}; x < img.GetWidth(); ++x)
-            if (auto px =
-                    inv(geometry::geographic::point(x + mbr->m_x, y + mbr->m_y))
-                        .and_then(pixel)) {
-                rgb[x] =
-                    wxImage::RGBValue(get_color(*px, boost::gil::red_t()),
-                                      get_color(*px, boost::gil::green_t()),
-                                      get_color(*px, boost::gil::blue_t()));
-                alpha[x] = get_color(*px, boost::gil::alpha_t());
+    constexpr auto band = 16;
+    auto bands = std::views::iota(0, (img.GetHeight() + band - 1) / band);
+    std::for_each(policy, bands.begin(), bands.end(), [&](int i) {
+        auto y0 = i * band, h = std::min<>(band, img.GetHeight() - y0);
+        auto src = std::vector<geometry::geographic::point>(h * img.GetWidth());
+        auto row = std::vector<boost::gil::rgba8_pixel_t>(img.GetWidth());
+        approximate(inv, mbr->m_x, mbr->m_y + y0, img.GetWidth(), h, src);
+        for (int y{}; y < h; ++y) {
+            resample(in,
+                     std::span{src}.subspan(y * img.GetWidth(), row.size()),
+                     row.data(),
+                     f);
+            auto d = (y0 + y) * img.GetWidth();
+            auto rgb = reinterpret_cast<wxImage::RGBValue*>(img.GetData()) + d;
+            auto alpha = img.GetAlpha() + d;
+            for (auto [x, px] : std::views::enumerate(row)) {
+                rgb[x] = wxImage::RGBValue(px[0], px[1], px[2]);
+                alpha[x] = px[3];
             }
-            else
-                alpha[x] = wxIMAGE_ALPHA_TRANSPARENT;
+        }
     });
     out.DrawBitmap(out.CreateBitmapFromImage(img), *mbr);
 }
@@ -31,9 +31,38 @@ public:
         throw err;
     }
 
-    db::rowset select(db::table const&, db::page const&) override { throw err; }
+    db::rowset select(  //
+        db::table const&,
+        db::page const&,
+        std::stop_token = {}) override
+    {
+        throw err;
+    }
 
-    db::rowset select(db::table const&, db::bbox const&) override { throw err; }
+    db::rowset select(  //
+        db::table const&,
+        db::bbox const&,
+        std::stop_token = {}) override
+    {
+        throw err;
+    }
+
+    std::generator<db::rowset> select(  //
+        db::table,
+        std::vector<db::bbox>,
+        std::stop_token = {}) override
+    {
+        throw err;
+        co_return;
+    }
+
+    std::generator<db::rowset> scan(db::table,
+                                    std::vector<std::string>,
+                                    size_t) override
+    {
+        throw err;
+        co_return;
+    }
 
     void insert(  //
         db::table const&,
@@ -76,7 +105,8 @@ public:
 
     std::generator<std::pair<tile, gil::any_image>> read(
         db::raster,
-        std::vector<tile> ts) override
+        std::vector<tile> ts,
+        std::stop_token tok = {}) override
     {
         auto q = curl{};
         auto m = std::map<std::string, tile>{};
@@ -88,7 +118,7 @@ public:
             q.push(u.data(), agent.data(), ssl);
             m.insert({u, t});
         }
-        while (q.size()) {
+        while (q.size() && !tok.stop_requested()) {
             auto [u, img] = q.pop();
             co_yield {m.at(u), gil::read<boost::gil::rgba8_image_t>(img)};
         }
@@ -10,12 +10,185 @@ namespace boat::sql {
 
 class catalog : public db::catalog {
     inline static auto err = std::logic_error{"sql"};
+    bool bulk_{};
+    std::vector<std::pair<std::string, std::string>> deferred_;
 
     auto& dial() { return dialects::find(command->dbms()); }
 
+    auto cancel_on(std::stop_token tok)
+    {
+        return std::stop_callback{std::move(tok),
+                                  [this] { command->cancel(); }};
+    }
+
+    /// spatialite rebuilds r-tree faster than it maintains it row by row
+    void defer_spatial_index(db::table const& tbl)
+    {
+        for (auto idx : tbl.indices()) {
+            auto key = std::ranges::begin(idx);
+            if (std::ranges::size(idx) != 1u ||
+                !geo(tbl.columns, key->column_name))
+                continue;
+            auto item = std::pair{tbl.table_name, key->column_name};
+            if (std::ranges::contains(deferred_, item))
+                continue;
+            command->exec(disable_spatial_index(item.first, item.second));
+            deferred_.push_back(std::move(item));
+        }
+    }
+
+    static db::query disable_spatial_index(std::string_view table_name,
+                                           std::string_view column_name)
+    {
+        return {"\n select DisableSpatialIndex(f_table_name, f_geometry_column)"
+                "\n from geometry_columns"
+                "\n where f_table_name like ",
+                db::variant{table_name},
+                "\n and f_geometry_column like ",
+                db::variant{column_name},
+                "\n and spatial_index_enabled;"
+                "\n drop table if exists ",
+                db::id{concat("idx_", table_name, "_", column_name)},
+                ";"};
+    }
+
+    /// variant alternative of each column, none if mixed
+    static std::optional<std::vector<size_t>> alternatives(
+        db::rowset const& rs)
+    {
+        auto ret = std::vector<size_t>(rs.columns.size());
+        for (auto& row : rs)
+            for (auto [i, var] : std::views::zip(ret, row))
+                if (var.has_value()) {
+                    if (i && i != var.index())
+                        return std::nullopt;
+                    i = var.index();
+                }
+        return ret;
+    }
+
+    static std::optional<std::vector<size_t>> alternatives(
+        db::column_batch const& cb)
+    {
+        if (std::ranges::contains(cb.columns,
+                                  db::column_batch::column::mixed,
+                                  &db::column_batch::column::index))
+            return std::nullopt;
+        return cb.columns |
+               std::views::transform(&db::column_batch::column::index) |
+               std::ranges::to<std::vector>();
+    }
+
+    static auto names(db::rowset const& rs) { return rs.columns; }
+
+    static auto names(db::column_batch const& cb)
+    {
+        return cb.columns |
+               std::views::transform(&db::column_batch::column::name) |
+               std::ranges::to<std::vector>();
+    }
+
+    bool copy_in(db::query const& qry, db::rowset const& rs)
+    {
+        return command->copy(qry, rs);
+    }
+
+    bool copy_in(db::query const& qry, db::column_batch const& cb)
+    {
+        return command->copy_columns(qry, cb);
+    }
+
+    /// rowset or column batch through a staging table
+    bool copy(db::table const& tbl, auto const& batch, std::stop_token tok)
+    {
+        constexpr char const* types[] = {
+            "text", "int8", "float8", "text", "bytea"};  //< by variant index
+        auto idx = alternatives(batch);
+        if (!idx)
+            return false;
+        auto cols = names(batch);
+        auto key = std::string{};
+        for (auto [col, i] : std::views::zip(cols, *idx))
+            key.append(col).append(" ").append(types[i]).append(",");
+        auto stage = db::id{
+            concat("boat_copy_", std::hash<std::string>{}(key))};  //< reused
+        auto q = db::query{"create temp table if not exists ", stage};
+        for (auto sep{" ("}; auto [col, i] : std::views::zip(cols, *idx))
+            q << std::exchange(sep, ", ") << db::id{col} << " " << types[i];
+        auto _ = cancel_on(std::move(tok));
+        command->exec(q << ");\n truncate " << stage);
+        if (!copy_in({"copy ", stage, " from stdin (format binary)"}, batch))
+            return false;
+        q = db::query{"\n insert into ", id{tbl}};
+        for (auto sep{" ("}; auto& col : cols)
+            q << std::exchange(sep, ", ") << db::id{col};
+        for (auto sep{")\n select "};
+             auto [col, i] : std::views::zip(cols, *idx)) {
+            q << std::exchange(sep, ", ");
+            if (i)
+                adaptors::make(tbl.dbms, find(tbl.columns, col))
+                    ->insert(q, db::id{col});
+            else
+                q << "null";  //< takes the target type, unlike staged text
+        }
+        command->exec(q << "\n from " << stage << ";\n truncate " << stage);
+        return true;
+    }
+
+    /// parameter arrays if the command binds them, all-null columns are
+    /// inlined as they have no type to bind
+    bool exec_batch(db::table const& tbl,
+                    db::rowset const& rs,
+                    std::vector<std::unique_ptr<adaptors::adaptor>> const& cols,
+                    std::stop_token tok)
+    {
+        auto valued = std::vector<char>(rs.columns.size());
+        for (auto& row : rs)
+            for (auto [v, var] : std::views::zip(valued, row))
+                v = v || var.has_value();
+        auto q = db::query{"\n insert into ", id{tbl}};
+        for (auto sep{"\n   ("}; auto& col : rs.columns)
+            q << std::exchange(sep, ", ") << db::id(col);
+        for (auto sep{")\n values\n   ("};
+             auto [c, v] : std::views::zip(cols, valued)) {
+            q << std::exchange(sep, ", ");
+            if (v)
+                c->insert(q, {command->param_mark()});
+            else
+                q << "null";
+        }
+        q << ")";
+        auto params = db::rowset{};
+        auto typed = std::ranges::all_of(valued, std::identity{});
+        if (!typed) {
+            for (auto [col, v] : std::views::zip(rs.columns, valued))
+                if (v)
+                    params.columns.push_back(col);
+            auto is_valued = [](auto&& item) { return std::get<1>(item); };
+            for (auto& row : rs)
+                params.rows.push_back(std::views::zip(row, valued) |
+                                      std::views::filter(is_valued) |
+                                      std::views::keys |
+                                      std::ranges::to<std::vector>());
+        }
+        auto _ = cancel_on(std::move(tok));
+        return command->exec_batch(q, typed ? rs : params);
+    }
+
 public:
     std::unique_ptr<db::command> command;
 
+    /// leaves no table without its r-tree if a bulk load was interrupted
+    ~catalog() override
+    {
+        if (bulk_ && command)
+            try {
+                set_autocommit(true);
+            }
+            catch (std::exception const&) {
+            }
+    }
+
     std::vector<db::source> sources() override { return {}; }
 
     std::vector<db::layer> layers() override
@@ -24,6 +197,8 @@ public:
                 command->exec(dial().layers()) | db::view<db::layer>};
     }
 
+    void ping() override { command->exec("select 1"); }
+
     db::table get_table(std::string_view schema_name,
                         std::string_view table_name) override
     {
@@ -47,16 +222,68 @@ public:
         return ret;
     }
 
-    db::rowset select(db::table const& tbl, db::page const& rq) override
+    db::rowset select(  //
+        db::table const& tbl,
+        db::page const& rq,
+        std::stop_token tok = {}) override
     {
+        auto _ = cancel_on(std::move(tok));
         return command->exec(dial().select(tbl, rq));
     }
 
-    db::rowset select(db::table const& tbl, db::bbox const& rq) override
+    db::rowset select(  //
+        db::table const& tbl,
+        db::bbox const& rq,
+        std::stop_token tok = {}) override
     {
+        auto _ = cancel_on(std::move(tok));
         return command->exec(dial().select(tbl, rq));
     }
 
+    std::generator<db::rowset> select(  //
+        db::table tbl,
+        std::vector<db::bbox> rqs,
+        std::stop_token tok = {}) override
+    {
+        auto qrys = std::vector<db::query>{};
+        for (auto& rq : rqs)
+            qrys.push_back(dial().select(tbl, rq));
+        auto _ = cancel_on(std::move(tok));
+        co_yield std::ranges::elements_of(command->exec_many(std::move(qrys)));
+    }
+
+    void visit(db::table const& tbl,
+               std::vector<db::bbox> rqs,
+               db::row_visitor const& f,
+               std::stop_token tok = {}) override
+    {
+        auto qrys = std::vector<db::query>{};
+        for (auto& rq : rqs)
+            qrys.push_back(dial().select(tbl, rq));
+        auto _ = cancel_on(std::move(tok));
+        command->visit(std::move(qrys), f);
+    }
+
+    std::generator<db::rowset> scan(
+        db::table tbl,
+        std::vector<std::string> cols,
+        size_t batch_size) override
+    {
+        auto q = db::query{};
+        q << "\n select " << select_list{tbl, cols} << "\n from " << id{tbl};
+        return command->scan(std::move(q), batch_size);
+    }
+
+    std::generator<db::column_batch> scan_columns(
+        db::table tbl,
+        std::vector<std::string> cols,
+        size_t batch_size) override
+    {
+        auto q = db::query{};
+        q << "\n select " << select_list{tbl, cols} << "\n from " << id{tbl};
+        return command->scan_columns(std::move(q), batch_size);
+    }
+
     void insert(  //
         db::table const& tbl,
         db::rowset const& rs,
@@ -65,9 +292,16 @@ public:
         if (rs.empty())
             return;
         check(!rs.columns.empty(), "no columns");
+        if (bulk_ && is_sqlite(tbl.dbms))
+            defer_spatial_index(tbl);
         auto cols = std::vector<std::unique_ptr<adaptors::adaptor>>{};
         for (auto& col : rs.columns)
             cols.push_back(adaptors::make(tbl.dbms, find(tbl.columns, col)));
+        if (!tok.stop_requested() && exec_batch(tbl, rs, cols, tok))
+            return;
+        if (is_postgres(tbl.dbms) && !tok.stop_requested() &&
+            copy(tbl, rs, tok))
+            return;
         for (auto&& rows :
              rs | std::views::chunk(std::max<>(1uz, 999uz / cols.size()))) {
             if (tok.stop_requested())
@@ -87,10 +321,25 @@ public:
         }
     }
 
+    /// COPY encodes straight from the column arenas
+    void insert_columns(db::table const& tbl,
+                        db::column_batch const& cb,
+                        std::stop_token tok = {}) override
+    {
+        if (cb.empty())
+            return;
+        if (bulk_ && is_sqlite(tbl.dbms))
+            defer_spatial_index(tbl);
+        if (!is_postgres(tbl.dbms) || tok.stop_requested() ||
+            !copy(tbl, cb, tok))
+            insert(tbl, db::to_rowset(cb), std::move(tok));
+    }
+
     db::table create(db::table const& tbl) override
     {
         auto t = migrate(*command, tbl);
         command->exec(dial().create(t));
+        command->reset_statements();
         return get_table(t.schema_name, t.table_name);
     }
 
@@ -99,13 +348,15 @@ public:
     {
         auto scm = current_schema_or(*command, schema_name);
         command->exec({"drop table if exists ", id{scm, table_name}});
+        command->reset_statements();
     }
 
     db::raster get_raster(db::layer const&) override { throw err; }
 
     std::generator<std::pair<tile, gil::any_image>> read(
         db::raster,
-        std::vector<tile>) override
+        std::vector<tile>,
+        std::stop_token = {}) override
     {
         throw err;
         co_return;
@@ -116,7 +367,18 @@ public:
         throw err;
     }
 
-    void set_autocommit(bool on) override { command->set_autocommit(on); }
+    void set_autocommit(bool on) override
+    {
+        command->set_autocommit(on);
+        bulk_ = !on;
+        if (on)
+            for (auto& [tbl, col] : std::exchange(deferred_, {})) {
+                auto q = disable_spatial_index(tbl, col);
+                q << "\n select CreateSpatialIndex(" << db::variant{tbl} << ", "
+                  << db::variant{col} << ");";
+                command->exec(q);
+            }
+    }
 
     void commit() override { command->commit(); }
 };
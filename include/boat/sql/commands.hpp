@@ -85,8 +85,11 @@ inline std::unique_ptr<db::command> make_command(std::string_view url)
 #endif
     if (url.starts_with("sqlite://"))
 #if __has_include(<sqlite3.h>)
+    {
+        auto u = uri::parse(url);
         return std::make_unique<sqlite::command>(
-            std::string{uri::parse(url).path}.data());
+            std::string{u.path}.data(), u.query == "mode=ro");
+    }
 #else
         throw std::runtime_error("compiled without sqlite");
 #endif
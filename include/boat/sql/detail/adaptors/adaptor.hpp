@@ -13,7 +13,7 @@ struct adaptor {
     virtual std::string_view parse() const = 0;
     virtual db::column migrate(std::string_view dbms) const = 0;
     virtual void select(db::query&) const = 0;
-    virtual void insert(db::query&, db::variant) const = 0;
+    virtual void insert(db::query&, db::query) const = 0;
 };
 
 template <class T>
@@ -39,9 +39,9 @@ public:
         qry << db::id{col_->column_name};
     }
 
-    void insert(db::query& qry, db::variant var) const override
+    void insert(db::query& qry, db::query expr) const override
     {
-        qry << std::move(var);
+        qry << expr;
     }
 };
 
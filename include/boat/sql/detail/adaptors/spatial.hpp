@@ -28,16 +28,16 @@ struct spatial : impl<geometry::geographic::variant> {
             qry << "ST_AsBinary(" << id << ") " << id;
     }
 
-    void insert(db::query& qry, db::variant var) const override
+    void insert(db::query& qry, db::query expr) const override
     {
         auto srid = to_chars(col_->srid);
         if (is_mysql(dbms_))
-            qry << "ST_GeomFromWKB(" << std::move(var) << ", " << srid
+            qry << "ST_GeomFromWKB(" << expr << ", " << srid
                 << ", 'axis-order=long-lat')";
         else if (is_postgres(dbms_) && type() == "geography")
-            qry << "ST_GeogFromWKB(" << std::move(var) << ")";
+            qry << "ST_GeogFromWKB(" << expr << ")";
         else
-            qry << "ST_GeomFromWKB(" << std::move(var) << ", " << srid << ")";
+            qry << "ST_GeomFromWKB(" << expr << ", " << srid << ")";
     }
 };
 
@@ -36,15 +36,14 @@ struct timestamp : impl<std::chrono::sys_seconds> {
             qry << "cast(" << id << " as varchar(50)) " << id;
     }
 
-    void insert(db::query& qry, db::variant var) const override
+    void insert(db::query& qry, db::query expr) const override
     {
         if (is_mysql(dbms_))
-            qry << "str_to_date(" << std::move(var)
-                << ", '%Y-%m-%d %H:%i:%s.%f')";
+            qry << "str_to_date(" << expr << ", '%Y-%m-%d %H:%i:%s.%f')";
         else if (is_sqlite(dbms_))
-            qry << std::move(var);
+            qry << expr;
         else
-            qry << "cast(" << std::move(var) << " as " << type() << ")";
+            qry << "cast(" << expr << " as " << type() << ")";
     }
 };
 
@@ -61,8 +61,9 @@ struct mysql : dialect {
     {
         auto q = db::query{};
         q << "\n select " << select_list{tbl, rq.select_list} << "\n from "
-          << id{tbl} << order_by{tbl, rq.order_by} << "\n limit "
-          << to_chars(rq.limit) << "\n offset " << to_chars(rq.offset);
+          << id{tbl} << seek{tbl, rq.order_by, rq.after}
+          << order_by{tbl, rq.order_by} << "\n limit " << to_chars(rq.limit)
+          << "\n offset " << to_chars(rq.offset);
         return q;
     }
 
@@ -70,10 +71,18 @@ struct mysql : dialect {
     {
         auto& col = find_geo(tbl.columns, rq.layer_column);
         auto q = db::query{};
-        q << "\n select " << select_list{tbl, rq.select_list} << "\n from "
-          << id{tbl} << "\n where MBRIntersects("
+        q << "\n select "
+          << select_list{tbl, rq.select_list, rq.simplify_tolerance};
+        if (rq.sample > 0)
+            q << "\n from (select * from " << id{tbl};
+        else
+            q << "\n from " << id{tbl};
+        q << "\n where MBRIntersects("
           << rect{tbl.dbms, col, rq.xmin, rq.ymin, rq.xmax, rq.ymax} << ", "
           << db::id(col.column_name) << ")\n limit " << to_chars(rq.limit);
+        if (rq.sample > 0)
+            q << ") " << db::id{tbl.table_name}
+              << "\n order by rand() limit " << to_chars(rq.sample);
         return q;
     }
 
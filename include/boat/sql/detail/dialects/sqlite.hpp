@@ -69,7 +69,8 @@ struct sqlite : dialect {
     {
         auto q = db::query{};
         q << "\n select " << select_list{tbl, rq.select_list}  //
-          << "\n from " << db::id{tbl.table_name} << order_by{tbl, rq.order_by}
+          << "\n from " << db::id{tbl.table_name}  //
+          << seek{tbl, rq.order_by, rq.after} << order_by{tbl, rq.order_by}
           << "\n limit " << to_chars(rq.limit)  //
           << "\n offset " << to_chars(rq.offset);
         return q;
@@ -82,15 +83,20 @@ struct sqlite : dialect {
             tbl.index_keys, col.column_name, &db::index_key::column_name);
         check(key != tbl.index_keys.end(), "no spatial index");
         auto q = db::query{};
-        q << "\n select " << select_list{tbl, rq.select_list}  //
-          << "\n from " << db::id{tbl.table_name}
-          << "\n where rowid in (select pkid from " << db::id{key->index_name}
+        q << "\n select "
+          << select_list{tbl, rq.select_list, rq.simplify_tolerance}
+          << "\n from " << db::id{tbl.table_name} << "\n where rowid in (";
+        if (rq.sample > 0)
+            q << "select pkid from (";
+        q << "select pkid from " << db::id{key->index_name}
           << "\n  where xmax >= " << db::variant(rq.xmin)
           << "\n  and xmin <= " << db::variant(rq.xmax)
           << "\n  and ymax >= " << db::variant(rq.ymin)
           << "\n  and ymin <= " << db::variant(rq.ymax)  //
-          << "\n  limit " << to_chars(rq.limit) << ");";
-        return q;
+          << "\n  limit " << to_chars(rq.limit);
+        if (rq.sample > 0)
+            q << ") order by random() limit " << to_chars(rq.sample);
+        return q << ");";
     }
 
     db::query schema() const override { return "select null"; }
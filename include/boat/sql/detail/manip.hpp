@@ -37,15 +37,39 @@ struct index_spec {
     }
 };
 
+struct simplified {
+    std::string_view dbms;
+    db::column const& col;
+    double tolerance;
+
+    friend db::query& operator<<(db::query& out, simplified const& in)
+    {
+        auto id = db::id{in.col.column_name};
+        auto tol = db::variant{in.tolerance};
+        if (is_mysql(in.dbms))  //< not implemented for geographic srs
+            return out << "ST_AsBinary(ST_Simplify(ST_SRID(" << id << ", 0), "
+                       << tol << ")) " << id;
+        if (is_postgres(in.dbms))
+            return out << "ST_AsBinary(ST_SimplifyPreserveTopology(" << id
+                       << "::geometry, " << tol << ")) " << id;
+        return out << "ST_AsBinary(SimplifyPreserveTopology(" << id << ", "
+                   << tol << ")) " << id;
+    }
+};
+
 struct select_list {
     db::table const& tbl;
     std::span<std::string const> cols;
+    double tolerance{};  //< simplifies geometries, if positive
 
     void print(db::query& out, range_of<db::column> auto&& cols) const
     {
         for (auto sep{""}; auto const& col : cols) {
             out << std::exchange(sep, ", ");
-            adaptors::make(tbl.dbms, col)->select(out);
+            if (tolerance > 0 && geo(col))
+                out << simplified{tbl.dbms, col, tolerance};
+            else
+                adaptors::make(tbl.dbms, col)->select(out);
         }
     }
 
@@ -60,25 +84,74 @@ struct select_list {
     }
 };
 
+inline std::vector<db::order_key> order_keys(
+    db::table const& tbl,
+    std::span<db::order_key const> keys)
+{
+    if (!keys.empty())
+        return {keys.begin(), keys.end()};
+    for (auto idx :
+         tbl.indices() | std::views::filter(orderable) | std::views::take(1))
+        return idx | std::views::transform([](auto& key) {
+                   return db::order_key{key.column_name, key.descending};
+               }) |
+               std::ranges::to<std::vector>();
+    return {};
+}
+
 struct order_by {
     db::table const& tbl;
     std::span<db::order_key const> keys;
 
-    void print(db::query& out, auto&& keys) const
+    friend db::query& operator<<(db::query& out, order_by const& in)
     {
-        for (auto sep{"\n order by "}; auto& key : keys)
-            out << std::exchange(sep, ", ") << db::id{tbl.table_name} << "."
+        for (auto sep{"\n order by "}; auto& key : order_keys(in.tbl, in.keys))
+            out << std::exchange(sep, ", ") << db::id{in.tbl.table_name} << "."
                 << db::id{key.column_name} << (key.descending ? " desc" : "");
+        return out;
     }
+};
 
-    friend db::query& operator<<(db::query& out, order_by const& in)
+struct seek {
+    db::table const& tbl;
+    std::span<db::order_key const> keys;
+    std::span<db::variant const> vals;
+
+    void print(db::query& out, db::order_key const& key, db::variant val) const
     {
-        if (in.keys.empty())
-            for (auto idx : in.tbl.indices() | std::views::filter(orderable) |
-                                std::views::take(1))
-                in.print(out, idx);
-        else
-            in.print(out, in.keys);
+        auto& col = find(tbl.columns, key.column_name);
+        adaptors::make(tbl.dbms, col)->insert(out, std::move(val));
+    }
+
+    friend db::query& operator<<(db::query& out, seek const& in)
+    {
+        if (in.vals.empty())
+            return out;
+        auto keys = order_keys(in.tbl, in.keys);
+        check(keys.size() == in.vals.size(), "seek keys");
+        auto desc = keys.front().descending;
+        if (std::ranges::all_of(keys, [&](auto& key) {
+                return key.descending == desc;
+            })) {
+            for (auto sep{"\n where ("}; auto& key : keys)
+                out << std::exchange(sep, ", ") << db::id{key.column_name};
+            for (auto sep{desc ? ") < (" : ") > ("};
+                 auto [key, val] : std::views::zip(keys, in.vals)) {
+                out << std::exchange(sep, ", ");
+                in.print(out, key, val);
+            }
+            return out << ")";
+        }
+        out << "\n where ";
+        for (size_t i{}; i < keys.size(); ++i) {
+            out << (i ? "\n or (" : "(");
+            for (size_t j{}; j <= i; ++j) {
+                out << (j ? " and " : "") << db::id{keys[j].column_name}
+                    << (j < i ? " = " : keys[j].descending ? " < " : " > ");
+                in.print(out, keys[j], in.vals[j]);
+            }
+            out << ")";
+        }
         return out;
     }
 };
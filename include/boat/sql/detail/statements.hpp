@@ -0,0 +1,59 @@
+// Andrew Naplavkov
+
+#ifndef BOAT_SQL_STATEMENTS_HPP
+#define BOAT_SQL_STATEMENTS_HPP
+
+#include <boat/detail/config.hpp>
+#include <boat/detail/linked_hash_map.hpp>
+#include <optional>
+#include <string>
+
+namespace boat::sql {
+
+/// LRU cache of prepared statements keyed by query text
+template <class T>
+class statement_cache {
+    linked_hash_map<std::string, T> data_;
+    size_t hits_{};
+    size_t misses_{};
+
+public:
+    size_t size() const { return data_.size(); }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+    T* find(std::string const& txt)
+    {
+        auto it = data_.find(txt);
+        if (it == data_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        data_.transfer(it, data_.end());
+        return &it->second;
+    }
+
+    /// makes room for one more statement
+    std::optional<T> evict()
+    {
+        if (data_.size() < statement_cache_size)
+            return std::nullopt;
+        auto ret = std::optional<T>{std::move(data_.begin()->second)};
+        data_.erase(data_.begin());
+        return ret;
+    }
+
+    void clear() { data_.clear(); }
+
+    T& put(std::string txt, T val)
+    {
+        evict();
+        auto it = data_.insert(data_.end(), {std::move(txt), std::move(val)});
+        return it.first->second;
+    }
+};
+
+}  // namespace boat::sql
+
+#endif  // BOAT_SQL_STATEMENTS_HPP
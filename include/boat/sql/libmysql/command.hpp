@@ -5,41 +5,59 @@
 
 #include <boat/db/command.hpp>
 #include <boat/detail/config.hpp>
+#include <boat/sql/detail/statements.hpp>
 #include <boat/sql/libmysql/detail/fetch.hpp>
+#include <cstdio>
+#include <mutex>
 
 namespace boat::sql::libmysql {
 
 class command : public db::command {
     unique_ptr<MYSQL, mysql_close> dbc_;
-    unique_ptr<MYSQL_STMT, mysql_stmt_close> stmt_;
-    std::string prepared_;
+    statement_cache<unique_ptr<MYSQL_STMT, mysql_stmt_close>> statements_;
+    unique_ptr<MYSQL, mysql_close> killer_;  //< so cancel needs no password
+    unsigned long thread_id_;
+    std::mutex running_guard_;
+    bool running_{};  //< a late kill would interrupt the next query
 
-public:
-    command(char const* user,
-            char const* password,
-            char const* host,
-            int port,
-            char const* database)
+    static auto connect(char const* user,
+                        char const* password,
+                        char const* host,
+                        int port,
+                        char const* database)
     {
         auto seconds =
             static_cast<unsigned>(std::chrono::seconds{timeout}.count());
-        dbc_.reset(mysql_init(0));
-        check(!!dbc_, dbc_);
+        auto ret = unique_ptr<MYSQL, mysql_close>{mysql_init(0)};
+        check(!!ret, ret);
         for (auto opt : {MYSQL_OPT_CONNECT_TIMEOUT,
                          MYSQL_OPT_READ_TIMEOUT,
                          MYSQL_OPT_WRITE_TIMEOUT})
-            check(!mysql_options(dbc_.get(), opt, &seconds), dbc_);
+            check(!mysql_options(ret.get(), opt, &seconds), ret);
         check(mysql_real_connect(  //
-                  dbc_.get(),
+                  ret.get(),
                   host,
                   user,
                   password,
                   database,
                   port,
                   0,
-                  CLIENT_MULTI_STATEMENTS) == dbc_.get(),
-              dbc_);
+                  CLIENT_MULTI_STATEMENTS) == ret.get(),
+              ret);
+        return ret;
+    }
+
+public:
+    command(char const* user,
+            char const* password,
+            char const* host,
+            int port,
+            char const* database)
+        : dbc_{connect(user, password, host, port, database)}
+        , thread_id_{mysql_thread_id(dbc_.get())}
+    {
         check(!mysql_set_character_set(dbc_.get(), "utf8"), dbc_);
+        killer_ = connect(user, password, host, port, 0);
     }
 
     db::rowset exec(db::query const& qry) override
@@ -48,9 +66,8 @@ public:
         auto txt = qry.text(id_quote(), param_mark());
         auto ps = qry.params() | std::views::transform(to_bind) |
                   std::ranges::to<std::vector>();
+        auto _ = run();
         if (ps.empty()) {
-            stmt_.reset();
-            prepared_.clear();
             check(!mysql_query(dbc_.get(), txt.data()), dbc_);
             for (int ec{}; ec >= 0; ec = mysql_next_result(dbc_.get())) {
                 check(!ec, dbc_);
@@ -58,26 +75,87 @@ public:
             }
         }
         else {
-            if (prepared_ != txt) {
-                stmt_.reset(mysql_stmt_init(dbc_.get()));
-                check(!!stmt_, dbc_);
+            MYSQL_STMT* stmt;
+            if (auto ptr = statements_.find(txt))
+                stmt = ptr->get();
+            else {
+                auto fresh = unique_ptr<MYSQL_STMT, mysql_stmt_close>{
+                    mysql_stmt_init(dbc_.get())};
+                check(!!fresh, dbc_);
                 check(!mysql_stmt_prepare(  //
-                          stmt_.get(),
+                          fresh.get(),
                           txt.data(),
                           static_cast<unsigned long>(txt.size())),
-                      stmt_);
-                prepared_ = txt;
+                      fresh);
+                stmt = fresh.get();
+                statements_.put(txt, std::move(fresh));
             }
-            check(!mysql_stmt_bind_param(stmt_.get(), ps.data()), stmt_);
-            check(!mysql_stmt_execute(stmt_.get()), stmt_);
-            for (int ec{}; ec >= 0; ec = mysql_stmt_next_result(stmt_.get())) {
-                check(!ec, stmt_);
-                ret = fetch(stmt_.get());
+            check(!mysql_stmt_bind_param(stmt, ps.data()), stmt);
+            check(!mysql_stmt_execute(stmt), stmt);
+            for (int ec{}; ec >= 0; ec = mysql_stmt_next_result(stmt)) {
+                check(!ec, stmt);
+                ret = fetch(stmt);
             }
         }
         return ret;
     }
 
+    std::generator<db::rowset> exec_many(std::vector<db::query> qrys) override
+    {
+        if (qrys.empty())
+            co_return;
+        auto txt = std::string{};
+        for (auto& qry : qrys)
+            txt.append(inline_text(qry)).append(";");
+        auto running = run();
+        check(!mysql_query(dbc_.get(), txt.data()), dbc_);
+        auto _ = finally{[&] {
+            while (!mysql_next_result(dbc_.get()))
+                unique_ptr<MYSQL_RES, mysql_free_result>{
+                    mysql_store_result(dbc_.get())};
+        }};
+        for (int ec{}; ec >= 0; ec = mysql_next_result(dbc_.get())) {
+            check(!ec, dbc_);
+            co_yield fetch(dbc_.get());
+        }
+    }
+
+    std::generator<db::rowset> scan(db::query qry, size_t batch_size) override
+    {
+        return stream(std::move(qry), [=](MYSQL_RES* res) {
+            return fetch(res, batch_size);
+        });
+    }
+
+    std::generator<db::column_batch> scan_columns(db::query qry,
+                                                  size_t batch_size) override
+    {
+        return stream(std::move(qry), [=](MYSQL_RES* res) {
+            return fetch_columns(res, batch_size);
+        });
+    }
+
+    bool copy(db::query const&, db::rowset const&) override { return false; }
+
+    bool exec_batch(db::query const&, db::rowset const&) override
+    {
+        return false;
+    }
+
+    /// runs from stop callbacks, so it does not throw
+    void cancel() noexcept override
+    {
+        auto lock = std::lock_guard{running_guard_};
+        if (!running_)
+            return;
+        char txt[48];
+        std::snprintf(txt, sizeof txt, "kill query %lu", thread_id_);
+        mysql_thread_init();
+        mysql_query(killer_.get(), txt);
+    }
+
+    void reset_statements() override { statements_.clear(); }
+
     void set_autocommit(bool on) override
     {
         if (on)
@@ -89,6 +167,55 @@ public:
     char id_quote() override { return '`'; }
     std::string param_mark() override { return "?"; }
     std::string dbms() override { return "mysql"; }
+    auto const& statements() const { return statements_; }
+
+private:
+    /// escapes as the connection's sql_mode and character set require
+    std::string inline_text(db::query const& qry)
+    {
+        return qry.text(id_quote(), {}, [this](std::string_view v) {
+            auto ret = std::string(v.size() * 2 + 1, '\0');
+            auto len = mysql_real_escape_string(
+                dbc_.get(),
+                ret.data(),
+                v.data(),
+                static_cast<unsigned long>(v.size()));
+            check(len != static_cast<unsigned long>(-1), dbc_);
+            ret.resize(len);
+            return ret;
+        });
+    }
+
+    /// batches fetched by f from an unbuffered result
+    template <class F>
+    std::generator<std::invoke_result_t<F, MYSQL_RES*>> stream(db::query qry,
+                                                               F f)
+    {
+        auto txt = inline_text(qry);
+        auto _ = run();
+        check(!mysql_query(dbc_.get(), txt.data()), dbc_);
+        auto res = unique_ptr<MYSQL_RES, mysql_free_result>{
+            mysql_use_result(dbc_.get())};
+        check(!!res, dbc_);
+        for (;;) {
+            auto batch = f(res.get());
+            check(!mysql_errno(dbc_.get()), dbc_);
+            if (batch.empty())
+                break;
+            co_yield std::move(batch);
+        }
+    }
+
+    /// the query ends after a kill sent meanwhile has been acknowledged
+    auto run()
+    {
+        auto lock = std::lock_guard{running_guard_};
+        running_ = true;
+        return finally{[this] {
+            auto lock = std::lock_guard{running_guard_};
+            running_ = false;
+        }};
+    }
 };
 
 }  // namespace boat::sql::libmysql
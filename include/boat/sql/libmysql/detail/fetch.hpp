@@ -3,46 +3,109 @@
 #ifndef BOAT_SQL_LIBMYSQL_FETCH_HPP
 #define BOAT_SQL_LIBMYSQL_FETCH_HPP
 
-#include <boat/db/rowset.hpp>
+#include <boat/db/column_batch.hpp>
 #include <boat/sql/libmysql/detail/utility.hpp>
+#include <cstring>
 
 namespace boat::sql::libmysql {
 
-inline db::rowset fetch(MYSQL* dbc)
+inline db::rowset fetch(MYSQL_RES* res, size_t limit)
 {
     auto ret = db::rowset{};
-    auto res =
-        unique_ptr<MYSQL_RES, mysql_free_result>{mysql_store_result(dbc)};
-    if (!res)
-        return ret;
-    ret.columns.resize(mysql_num_fields(res.get()));
-    auto fields = mysql_fetch_fields(res.get());
+    ret.columns.resize(mysql_num_fields(res));
+    auto fields = mysql_fetch_fields(res);
     for (size_t col = 0; col < ret.columns.size(); ++col)
         ret.columns[col] = fields[col].name;
-    ret.rows.resize(static_cast<size_t>(mysql_num_rows(res.get())));
-    for (size_t row = 0; row < ret.rows.size(); ++row) {
-        auto data = mysql_fetch_row(res.get());
-        auto lengths = mysql_fetch_lengths(res.get());
-        ret.rows[row].resize(ret.columns.size());
+    for (size_t row = 0; row < limit; ++row) {
+        auto data = mysql_fetch_row(res);
+        if (!data)
+            break;
+        auto lengths = mysql_fetch_lengths(res);
+        auto& vals = ret.rows.emplace_back(ret.columns.size());
         for (size_t col{}; col < ret.columns.size(); ++col)
-            ret.rows[row][col] =
-                get_value(fields[col], data[col], lengths[col]);
+            vals[col] = get_value(fields[col], data[col], lengths[col]);
     }
     return ret;
 }
 
+inline db::column_batch fetch_columns(MYSQL_RES* res, size_t limit)
+{
+    auto ret = db::column_batch{};
+    auto cols = mysql_num_fields(res);
+    auto fields = mysql_fetch_fields(res);
+    for (unsigned col{}; col < cols; ++col)
+        ret.columns.emplace_back().name = fields[col].name;
+    for (size_t row = 0; row < limit; ++row) {
+        auto data = mysql_fetch_row(res);
+        if (!data)
+            break;
+        auto lengths = mysql_fetch_lengths(res);
+        for (unsigned col{}; col < cols; ++col)
+            ret.columns[col].push_back(
+                get_view(fields[col], data[col], lengths[col]));
+    }
+    return ret;
+}
+
+inline db::rowset fetch(MYSQL* dbc)
+{
+    auto res =
+        unique_ptr<MYSQL_RES, mysql_free_result>{mysql_store_result(dbc)};
+    if (!res)
+        return {};
+    return fetch(res.get(), static_cast<size_t>(mysql_num_rows(res.get())));
+}
+
+inline db::variant get_value(  //
+    MYSQL_STMT* stmt,
+    MYSQL_FIELD const& fld,
+    MYSQL_BIND const& bind,
+    buffer const& buf,
+    unsigned col)
+{
+    if (buf.null)
+        return {};
+    auto chunked = [&]<class T>(std::type_identity<T>) {
+        auto ret = T(buf.len, {});
+        auto head = std::min<>(buf.len, bind.buffer_length);
+        std::memcpy(ret.data(), buf.str.data(), head);
+        if (head < buf.len) {
+            auto tail = MYSQL_BIND{};
+            tail.buffer_type = MYSQL_TYPE_BLOB;
+            tail.buffer = ret.data() + head;
+            tail.buffer_length = buf.len - head;
+            check(!mysql_stmt_fetch_column(stmt, &tail, col, head), stmt);
+        }
+        return db::variant{std::move(ret)};
+    };
+    switch (bind.buffer_type) {
+        case MYSQL_TYPE_LONGLONG:
+            if (bind.is_unsigned && buf.integer < 0)  //< above INT64_MAX
+                return static_cast<double>(
+                    std::bit_cast<uint64_t>(buf.integer));
+            return buf.integer;
+        case MYSQL_TYPE_DOUBLE:
+            return buf.real;
+        case MYSQL_TYPE_BLOB:
+            if (63u == fld.charsetnr && fld.type != MYSQL_TYPE_STRING &&
+                fld.type != MYSQL_TYPE_VAR_STRING &&
+                fld.type != MYSQL_TYPE_VARCHAR)
+                return chunked(std::type_identity<blob>{});
+            return chunked(std::type_identity<std::string>{});
+        default:
+            return {};
+    }
+}
+
+/// streams rows with native buffers, long values are fetched by parts
 inline db::rowset fetch(MYSQL_STMT* stmt)
 {
     auto ret = db::rowset{};
-    auto update_len = true;
-    check(!mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &update_len),
-          stmt);
-    check(!mysql_stmt_store_result(stmt), stmt);
-    auto _ = unique_ptr<MYSQL_STMT, mysql_stmt_free_result>{stmt};
     auto res = unique_ptr<MYSQL_RES, mysql_free_result>{
         mysql_stmt_result_metadata(stmt)};
     if (!res)
         return ret;
+    auto _ = unique_ptr<MYSQL_STMT, mysql_stmt_free_result>{stmt};
     auto cols = mysql_num_fields(res.get());
     ret.columns.resize(cols);
     auto binds = std::vector<MYSQL_BIND>(cols);
@@ -50,23 +113,16 @@ inline db::rowset fetch(MYSQL_STMT* stmt)
     auto fields = mysql_fetch_fields(res.get());
     for (size_t col{}; col < cols; ++col) {
         ret.columns[col] = fields[col].name;
-        bufs[col].str.resize(fields[col].max_length);
-        binds[col].buffer = bufs[col].str.data();
-        binds[col].buffer_length = fields[col].max_length;
-        binds[col].buffer_type = MYSQL_TYPE_STRING;
-        binds[col].is_null = &bufs[col].null;
-        binds[col].length = &bufs[col].len;
+        binds[col] = bind_result(fields[col], bufs[col]);
     }
     check(!mysql_stmt_bind_result(stmt, binds.data()), stmt);
-    auto rows = mysql_stmt_num_rows(stmt);
-    ret.rows.resize(rows);
-    for (size_t row{}; row < rows; ++row) {
-        check(!mysql_stmt_fetch(stmt), stmt);
-        ret.rows[row].resize(cols);
-        for (size_t col{}; col < cols; ++col)
-            if (!bufs[col].null)
-                ret.rows[row][col] =
-                    get_value(fields[col], bufs[col].str.data(), bufs[col].len);
+    int ec = mysql_stmt_fetch(stmt);
+    for (; MYSQL_NO_DATA != ec; ec = mysql_stmt_fetch(stmt)) {
+        check(!ec || MYSQL_DATA_TRUNCATED == ec, stmt);
+        auto& row = ret.rows.emplace_back(cols);
+        for (unsigned col{}; col < cols; ++col)
+            row[col] =
+                get_value(stmt, fields[col], binds[col], bufs[col], col);
     }
     return ret;
 }
@@ -9,8 +9,12 @@
 
 namespace boat::sql::libmysql {
 
+constexpr unsigned long chunk_size = 4096;  //< first part of long values
+
 struct buffer {
     std::string str;
+    int64_t integer;
+    double real;
     bool null;
     unsigned long len;
 };
@@ -61,7 +65,49 @@ inline MYSQL_BIND to_bind(db::variant const& var)
     return ret;
 }
 
-inline db::variant get_value(  //
+inline MYSQL_BIND bind_result(MYSQL_FIELD const& fld, buffer& buf)
+{
+    auto ret = MYSQL_BIND{};
+    ret.is_null = &buf.null;
+    ret.length = &buf.len;
+    switch (fld.type) {
+        case MYSQL_TYPE_NULL:
+            ret.buffer_type = MYSQL_TYPE_NULL;
+            return ret;
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_TINY:
+            ret.buffer_type = MYSQL_TYPE_LONGLONG;
+            ret.buffer = &buf.integer;
+            ret.is_unsigned = fld.flags & UNSIGNED_FLAG;
+            return ret;
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_DOUBLE:
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_NEWDECIMAL:
+            ret.buffer_type = MYSQL_TYPE_DOUBLE;
+            ret.buffer = &buf.real;
+            return ret;
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+        case MYSQL_TYPE_VARCHAR:
+            buf.str.resize(chunk_size);
+            ret.buffer_type = MYSQL_TYPE_BLOB;
+            ret.buffer = buf.str.data();
+            ret.buffer_length = chunk_size;
+            return ret;
+    }
+    throw std::runtime_error{concat(fld.name, " ", fld.type)};
+}
+
+/// borrows string and blob payloads from the row
+inline db::variant_view get_view(  //
     MYSQL_FIELD& fld,
     char const* ptr,
     unsigned long len)
@@ -76,6 +122,9 @@ inline db::variant get_value(  //
         case MYSQL_TYPE_LONGLONG:
         case MYSQL_TYPE_SHORT:
         case MYSQL_TYPE_TINY:
+            if (fld.flags & UNSIGNED_FLAG)
+                if (auto v = from_chars<uint64_t>(ptr, len); v > INT64_MAX)
+                    return static_cast<double>(v);  //< BIGINT UNSIGNED
             return from_chars<int64_t>(ptr, len);
         case MYSQL_TYPE_DECIMAL:
         case MYSQL_TYPE_DOUBLE:
@@ -87,17 +136,24 @@ inline db::variant get_value(  //
         case MYSQL_TYPE_MEDIUM_BLOB:
         case MYSQL_TYPE_TINY_BLOB:
             if (63u == fld.charsetnr)
-                return db::variant{
-                    std::in_place_type<blob>, as_bytes(ptr), len};
+                return blob_view{as_bytes(ptr), len};
             [[fallthrough]];
         case MYSQL_TYPE_STRING:
         case MYSQL_TYPE_VAR_STRING:
         case MYSQL_TYPE_VARCHAR:
-            return db::variant{std::in_place_type<std::string>, ptr, len};
+            return std::string_view{ptr, len};
     }
     throw std::runtime_error{concat(fld.name, " ", fld.type)};
 }
 
+inline db::variant get_value(  //
+    MYSQL_FIELD& fld,
+    char const* ptr,
+    unsigned long len)
+{
+    return db::own(get_view(fld, ptr, len));
+}
+
 }  // namespace boat::sql::libmysql
 
 #endif  // BOAT_SQL_LIBMYSQL_UTILITY_HPP
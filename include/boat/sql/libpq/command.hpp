@@ -4,19 +4,26 @@
 #define BOAT_SQL_LIBPQ_COMMAND_HPP
 
 #include <boat/db/command.hpp>
+#include <boat/sql/libpq/detail/copy.hpp>
 #include <boat/sql/libpq/detail/fetch.hpp>
 #include <boat/sql/libpq/detail/params.hpp>
+#include <boat/sql/detail/statements.hpp>
 
 namespace boat::sql::libpq {
 
 class command : public db::command {
     unique_ptr<PGconn, PQfinish> dbc_;
-    std::string prepared_;
+    unique_ptr<PGcancel, PQfreeCancel> cancel_;
+    statement_cache<std::string> statements_;  //< text to statement name
+    size_t cursors_{};
+    size_t names_{};
 
 public:
     explicit command(char const* connection) : dbc_(PQconnectdb(connection))
     {
         check(dbc_ && PQstatus(dbc_.get()) == CONNECTION_OK, dbc_.get());
+        cancel_.reset(PQgetCancel(dbc_.get()));
+        check(!!cancel_, dbc_.get());
     }
 
     db::rowset exec(db::query const& qry) override
@@ -29,20 +36,6 @@ public:
                 unique_ptr<PGresult, PQclear>{PQexec(dbc_.get(), txt.data())};
             return fetch(res.get());
         }
-        if (prepared_ != txt) {
-            auto types = std::vector<Oid>(ps.size());
-            for (size_t i{}; i < ps.size(); ++i)
-                types[i] = params::type(ps[i]);
-            auto res = unique_ptr<PGresult, PQclear>{PQprepare(  //
-                dbc_.get(),
-                "",
-                txt.data(),
-                static_cast<int>(types.size()),
-                types.data())};
-            auto ec = PQresultStatus(res.get());
-            check(ec == PGRES_COMMAND_OK || ec == PGRES_TUPLES_OK, dbc_.get());
-            prepared_ = txt;
-        }
         auto values = std::vector<char const*>(ps.size());
         auto lengths = std::vector<int>(ps.size());
         auto formats = std::vector<int>(ps.size());
@@ -52,22 +45,224 @@ public:
             lengths[i] = params::length(p);
             formats[i] = params::format(p);
         }
-        auto res = unique_ptr<PGresult, PQclear>{PQexecPrepared(  //
-            dbc_.get(),
-            "",
-            int(ps.size()),
-            values.data(),
-            lengths.data(),
-            formats.data(),
-            text_fmt)};
+        auto exec_prepared = [&] {
+            return unique_ptr<PGresult, PQclear>{PQexecPrepared(  //
+                dbc_.get(),
+                prepare(txt, ps).data(),
+                int(ps.size()),
+                values.data(),
+                lengths.data(),
+                formats.data(),
+                binary_fmt)};
+        };
+        auto res = exec_prepared();
+        if (auto state = PQresultErrorField(res.get(), PG_DIAG_SQLSTATE);
+            state && std::string_view{state} == feature_not_supported) {
+            reset_statements();  //< cached plan must not change result type
+            res = exec_prepared();
+        }
         return fetch(res.get());
     }
 
+    std::generator<db::rowset> exec_many(std::vector<db::query> qrys) override
+    {
+        check(PQenterPipelineMode(dbc_.get()) == 1, dbc_.get());
+        auto pending = false;  //< results before the sync point
+        auto synced = false;
+        auto _ = finally{[&] {
+            pending = pending && (synced || PQpipelineSync(dbc_.get()) == 1);
+            while (pending && PQstatus(dbc_.get()) == CONNECTION_OK) {
+                auto res =
+                    unique_ptr<PGresult, PQclear>{PQgetResult(dbc_.get())};
+                pending = PQresultStatus(res.get()) != PGRES_PIPELINE_SYNC;
+            }
+            PQexitPipelineMode(dbc_.get());
+        }};
+        for (auto& qry : qrys) {
+            send(qry);
+            pending = true;
+        }
+        synced = PQpipelineSync(dbc_.get()) == 1;
+        check(synced, dbc_.get());
+        for (size_t i{}; i < qrys.size(); ++i) {
+            auto res = unique_ptr<PGresult, PQclear>{PQgetResult(dbc_.get())};
+            auto rs = fetch(res.get());
+            res.reset(PQgetResult(dbc_.get()));  //< end of query
+            co_yield std::move(rs);
+        }
+    }
+
+    std::generator<db::rowset> scan(db::query qry, size_t batch_size) override
+    {
+        return stream(std::move(qry), batch_size, [](PGresult* res) {
+            return fetch(res);
+        });
+    }
+
+    std::generator<db::column_batch> scan_columns(db::query qry,
+                                                  size_t batch_size) override
+    {
+        return stream(std::move(qry), batch_size, [](PGresult* res) {
+            return fetch_columns(res);
+        });
+    }
+
+    bool copy(db::query const& qry, db::rowset const& rs) override
+    {
+        return copy_rows(qry, rs);
+    }
+
+    bool copy_columns(db::query const& qry,
+                      db::column_batch const& cb) override
+    {
+        auto rows =
+            std::views::iota(0uz, cb.size()) |
+            std::views::transform([&](size_t i) { return cb.row_view(i); });
+        return copy_rows(qry, rows);
+    }
+
+    bool exec_batch(db::query const&, db::rowset const&) override
+    {
+        return false;
+    }
+
+    void cancel() override
+    {
+        char err[256];
+        PQcancel(cancel_.get(), err, sizeof err);
+    }
+
+    void reset_statements() override
+    {
+        if (!statements_.size())
+            return;
+        unique_ptr<PGresult, PQclear>{PQexec(dbc_.get(), "deallocate all")};
+        statements_.clear();
+    }
+
     void set_autocommit(bool on) override { exec(on ? "rollback;" : "begin;"); }
     void commit() override { exec("commit;begin;"); }
     char id_quote() override { return '"'; }
     std::string param_mark() override { return "${}"; }
     std::string dbms() override { return "postgres"; }
+    auto const& statements() const { return statements_; }
+
+private:
+    static constexpr std::string_view feature_not_supported = "0A000";
+
+    bool copy_rows(db::query const& qry, std::ranges::input_range auto&& rows)
+    {
+        auto txt = qry.text(id_quote(), {});
+        auto res =
+            unique_ptr<PGresult, PQclear>{PQexec(dbc_.get(), txt.data())};
+        check(PQresultStatus(res.get()) == PGRES_COPY_IN, res.get());
+        auto buf = copy_header();
+        auto put = [&] {
+            check(PQputCopyData(dbc_.get(),
+                                as_chars(buf.data()),
+                                static_cast<int>(buf.size())) == 1,
+                  dbc_.get());
+            buf.clear();
+        };
+        for (auto&& row : rows) {
+            copy_row(buf, row);
+            if (buf.size() >= copy_buffer_size)
+                put();
+        }
+        copy_trailer(buf);
+        put();
+        check(PQputCopyEnd(dbc_.get(), 0) == 1, dbc_.get());
+        for (res.reset(PQgetResult(dbc_.get())); res;
+             res.reset(PQgetResult(dbc_.get())))
+            check(PQresultStatus(res.get()) == PGRES_COMMAND_OK, res.get());
+        return true;
+    }
+
+    std::string const& prepare(std::string const& txt,
+                               std::vector<params::param> const& ps)
+    {
+        if (auto ptr = statements_.find(txt))
+            return *ptr;
+        if (auto old = statements_.evict()) {
+            auto sql = concat("deallocate ", *old);
+            unique_ptr<PGresult, PQclear>{PQexec(dbc_.get(), sql.data())};
+        }
+        auto name = concat("boat_statement_", ++names_);
+        auto types = std::vector<Oid>(ps.size());
+        for (size_t i{}; i < ps.size(); ++i)
+            types[i] = params::type(ps[i]);
+        auto res = unique_ptr<PGresult, PQclear>{PQprepare(  //
+            dbc_.get(),
+            name.data(),
+            txt.data(),
+            static_cast<int>(types.size()),
+            types.data())};
+        auto ec = PQresultStatus(res.get());
+        check(ec == PGRES_COMMAND_OK || ec == PGRES_TUPLES_OK, dbc_.get());
+        return statements_.put(txt, std::move(name));
+    }
+
+    /// batches fetched from a cursor by f
+    template <class F>
+    std::generator<std::invoke_result_t<F, PGresult*>> stream(
+        db::query qry,
+        size_t batch_size,
+        F f)
+    {
+        auto idle = PQtransactionStatus(dbc_.get()) == PQTRANS_IDLE;
+        auto cur = concat("boat_cursor_", ++cursors_);
+        if (idle)
+            exec("begin;");
+        auto _ = finally{[&] {
+            auto txt = idle ? std::string{"rollback;"} : concat("close ", cur);
+            unique_ptr<PGresult, PQclear>{PQexec(dbc_.get(), txt.data())};
+        }};
+        auto declare = unique_ptr<PGresult, PQclear>{with_params(
+            db::query{"declare ", cur, " no scroll cursor for "} << qry,
+            PQexecParams)};  //< unnamed, cached statements stay
+        fetch(declare.get());
+        for (auto txt = concat("fetch forward ", batch_size, " from ", cur);;) {
+            auto res = unique_ptr<PGresult, PQclear>{
+                PQexecParams(dbc_.get(), txt.data(), 0, 0, 0, 0, 0, binary_fmt)};
+            auto batch = f(res.get());
+            if (batch.empty())
+                break;
+            co_yield std::move(batch);
+        }
+    }
+
+    void send(db::query const& qry)
+    {
+        check(with_params(qry, PQsendQueryParams) == 1, dbc_.get());
+    }
+
+    /// f is PQexecParams or alike, the statement is unnamed
+    template <class F>
+    auto with_params(db::query const& qry, F f)
+    {
+        auto txt = qry.text(id_quote(), param_mark());
+        auto ps = qry.params() | std::views::transform(params::make) |
+                  std::ranges::to<std::vector>();
+        auto types = std::vector<Oid>(ps.size());
+        auto values = std::vector<char const*>(ps.size());
+        auto lengths = std::vector<int>(ps.size());
+        auto formats = std::vector<int>(ps.size());
+        for (size_t i{}; i < ps.size(); ++i) {
+            auto& p = ps[i];
+            types[i] = params::type(p);
+            values[i] = params::value(p);
+            lengths[i] = params::length(p);
+            formats[i] = params::format(p);
+        }
+        return f(dbc_.get(),
+                 txt.data(),
+                 static_cast<int>(ps.size()),
+                 types.data(),
+                 values.data(),
+                 lengths.data(),
+                 formats.data(),
+                 binary_fmt);
+    }
 };
 
 }  // namespace boat::sql::libpq
@@ -0,0 +1,55 @@
+// Andrew Naplavkov
+
+#ifndef BOAT_SQL_LIBPQ_COPY_HPP
+#define BOAT_SQL_LIBPQ_COPY_HPP
+
+#include <boat/db/rowset.hpp>
+#include <boat/sql/libpq/detail/utility.hpp>
+
+namespace boat::sql::libpq {
+
+constexpr size_t copy_buffer_size = 1 << 20;
+
+template <arithmetic T>
+blob& host_to_network(blob& out, T val)
+{
+    if constexpr (std::endian::native != std::endian::big)
+        val = byteswap(val);
+    return out << val;
+}
+
+// https://www.postgresql.org/docs/current/sql-copy.html
+inline blob copy_header()
+{
+    auto ret = blob{as_bytes("PGCOPY\n\377\r\n"), 11};  //< with trailing zero
+    host_to_network(ret, int32_t{});                    //< flags
+    host_to_network(ret, int32_t{});                    //< extension length
+    return ret;
+}
+
+/// row of variants or variant views
+inline void copy_row(blob& out, std::ranges::sized_range auto&& row)
+{
+    host_to_network(out, static_cast<int16_t>(std::ranges::size(row)));
+    auto vis = overloaded{
+        [&](db::null) { host_to_network(out, int32_t{-1}); },
+        [&](arithmetic auto v) {
+            host_to_network(out, static_cast<int32_t>(sizeof v));
+            host_to_network(out, v);
+        },
+        [&](auto const& v) {
+            host_to_network(out, static_cast<int32_t>(v.size()));
+            out.append_range(std::as_bytes(std::span{v}));
+        }};
+    for (auto& var : row)
+        std::visit(vis, var);
+}
+
+inline void copy_trailer(blob& out)
+{
+    host_to_network(out, int16_t{-1});
+}
+
+}  // namespace boat::sql::libpq
+
+#endif  // BOAT_SQL_LIBPQ_COPY_HPP
@@ -3,20 +3,73 @@
 #ifndef BOAT_SQL_LIBPQ_FETCH_HPP
 #define BOAT_SQL_LIBPQ_FETCH_HPP
 
-#include <boat/db/rowset.hpp>
+#include <boat/db/column_batch.hpp>
 #include <boat/detail/string.hpp>
 #include <boat/sql/libpq/detail/utility.hpp>
 
 namespace boat::sql::libpq {
 
+template <arithmetic T>
+T network_to_host(blob_view& in)
+{
+    auto ret = T{};
+    in >> ret;
+    if constexpr (std::endian::native != std::endian::big)
+        ret = byteswap(ret);
+    return ret;
+}
+
+inline blob_view get_bytes(PGresult* res, int row, int col)
+{
+    return {as_bytes(PQgetvalue(res, row, col)),
+            static_cast<size_t>(PQgetlength(res, row, col))};
+}
+
 template <arithmetic T>
 T get(PGresult* res, int row, int col)
 {
-    return from_chars<T>(PQgetvalue(res, row, col), PQgetlength(res, row, col));
+    if (PQfformat(res, col) == text_fmt)
+        return from_chars<T>(PQgetvalue(res, row, col),
+                             PQgetlength(res, row, col));
+    auto in = get_bytes(res, row, col);
+    auto ret = network_to_host<T>(in);
+    if (!in.empty())
+        throw std::runtime_error{concat(PQfname(res, col), " PQgetlength")};
+    return ret;
+}
+
+// https://github.com/postgres/postgres/blob/master/src/backend/utils/adt/numeric.c
+inline double get_numeric(PGresult* res, int row, int col)
+{
+    if (PQfformat(res, col) == text_fmt)
+        return get<double>(res, row, col);
+    constexpr uint16_t neg = 0x4000;
+    constexpr uint16_t nan = 0xc000;
+    constexpr uint16_t pinf = 0xd000;  //< since PostgreSQL 14
+    constexpr uint16_t ninf = 0xf000;
+    auto in = get_bytes(res, row, col);
+    auto ndigits = network_to_host<uint16_t>(in);
+    auto weight = network_to_host<int16_t>(in);
+    auto sign = network_to_host<uint16_t>(in);
+    network_to_host<uint16_t>(in);  //< dscale
+    if (sign == nan)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (sign == pinf)
+        return std::numeric_limits<double>::infinity();
+    if (sign == ninf)
+        return -std::numeric_limits<double>::infinity();
+    auto ret = 0.;
+    for (int i{}; i < ndigits; ++i)
+        ret = ret * 10000 + network_to_host<uint16_t>(in);
+    auto exp = weight - ndigits + 1;
+    ret = exp < 0 ? ret / std::pow(10000., -exp) : ret * std::pow(10000., exp);
+    return sign == neg ? -ret : ret;
 }
 
 inline db::variant get_blob(PGresult* res, int row, int col)
 {
+    if (PQfformat(res, col) != text_fmt)
+        return db::variant{std::in_place_type<blob>, get_bytes(res, row, col)};
     auto ptr = (unsigned char const*)PQgetvalue(res, row, col);
     auto len = (size_t)PQgetlength(res, row, col);
     if (auto mem = unique_ptr<void, PQfreemem>(PQunescapeBytea(ptr, &len)))
@@ -28,20 +81,24 @@ inline db::variant get_value(PGresult* res, int row, int col)
 {
     if (PQgetisnull(res, row, col))
         return {};
-    if (PQfformat(res, col) != text_fmt)
-        throw std::runtime_error{concat(PQfname(res, col), " PQfformat")};
     auto type = PQftype(res, col);
     switch (type) {
         case bool_oid:
-            return *PQgetvalue(res, row, col) == 'f' ? 0 : 1;
+            if (auto v = *PQgetvalue(res, row, col); v == 'f' || v == 0)
+                return 0;
+            return 1;
         case int2_oid:
+            return get<int16_t>(res, row, col);
         case int4_oid:
+            return get<int32_t>(res, row, col);
         case int8_oid:
             return get<int64_t>(res, row, col);
         case float4_oid:
+            return get<float>(res, row, col);
         case float8_oid:
-        case numeric_oid:
             return get<double>(res, row, col);
+        case numeric_oid:
+            return get_numeric(res, row, col);
         case bpchar_oid:
         case name_oid:
         case text_oid:
@@ -55,6 +112,29 @@ inline db::variant get_value(PGresult* res, int row, int col)
     throw std::runtime_error{concat(PQfname(res, col), " ", type)};
 }
 
+/// borrows payloads from the result, buf holds converted values
+inline db::variant_view get_view(PGresult* res,
+                                 int row,
+                                 int col,
+                                 db::variant& buf)
+{
+    if (!PQgetisnull(res, row, col))
+        switch (PQftype(res, col)) {
+            case bpchar_oid:
+            case name_oid:
+            case text_oid:
+            case varchar_oid:
+                return std::string_view{
+                    PQgetvalue(res, row, col),
+                    static_cast<size_t>(PQgetlength(res, row, col))};
+            case bytea_oid:
+                if (PQfformat(res, col) != text_fmt)
+                    return get_bytes(res, row, col);
+        }
+    buf = get_value(res, row, col);
+    return db::borrow(buf);
+}
+
 inline db::rowset fetch(PGresult* res)
 {
     auto ec = PQresultStatus(res);
@@ -73,6 +153,22 @@ inline db::rowset fetch(PGresult* res)
     return ret;
 }
 
+inline db::column_batch fetch_columns(PGresult* res)
+{
+    auto ec = PQresultStatus(res);
+    check(ec == PGRES_COMMAND_OK || ec == PGRES_TUPLES_OK, res);
+    int cols = PQnfields(res);
+    int rows = PQntuples(res);
+    auto ret = db::column_batch{};
+    for (int col{}; col < cols; ++col)
+        ret.columns.emplace_back().name = PQfname(res, col);
+    auto buf = db::variant{};
+    for (int row{}; row < rows; ++row)
+        for (int col{}; col < cols; ++col)
+            ret.columns[col].push_back(get_view(res, row, col, buf));
+    return ret;
+}
+
 }  // namespace boat::sql::libpq
 
 #endif  // BOAT_SQL_LIBPQ_FETCH_HPP
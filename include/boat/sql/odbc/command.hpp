@@ -5,18 +5,22 @@
 
 #include <boat/db/command.hpp>
 #include <boat/detail/config.hpp>
-#include <boat/sql/odbc/detail/get_data.hpp>
+#include <boat/sql/detail/statements.hpp>
+#include <boat/sql/odbc/detail/block_cursor.hpp>
 #include <boat/sql/odbc/detail/params.hpp>
+#include <mutex>
 
 namespace boat::sql::odbc {
 
 class command : public db::command {
     env_ptr env_;
     dbc_ptr dbc_;
-    stmt_ptr stmt_;
+    statement_cache<stmt_ptr> statements_;
+    std::mutex running_guard_;
+    SQLHSTMT running_{};  //< executing statement to cancel
     char id_quote_;
     std::string dbms_;
-    std::basic_string<SQLWCHAR> prepared_;
+    SQLUINTEGER getdata_{};  //< SQL_GETDATA_EXTENSIONS
 
 public:
     explicit command(std::string_view connection)
@@ -44,51 +48,111 @@ public:
                   &len,
                   SQL_DRIVER_NOPROMPT),
               dbc_);
-        stmt_ = alloc<SQL_HANDLE_STMT>(dbc_);
         id_quote_ = info(dbc_, SQL_IDENTIFIER_QUOTE_CHAR).at(0);
         dbms_ = to_lower(info(dbc_, SQL_DBMS_NAME));
+        check(SQLGetInfo(dbc_.get(), SQL_GETDATA_EXTENSIONS, &getdata_, 0, 0),
+              dbc_);
     }
 
     db::rowset exec(db::query const& qry) override
     {
-        check(SQLFreeStmt(stmt_.get(), SQL_RESET_PARAMS), stmt_);
         auto ret = db::rowset{};
-        auto txt = qry.text(id_quote_, param_mark()) | unicode::utf<SQLWCHAR>;
-        if (txt != prepared_) {
-            check(SQLPrepareW(stmt_.get(), txt.data(), SQL_NTS), stmt_);
-            prepared_ = std::move(txt);
+        auto txt = qry.text(id_quote_, param_mark());
+        auto ptr = statements_.find(txt);
+        if (!ptr) {
+            auto stmt = alloc<SQL_HANDLE_STMT>(dbc_);
+            auto wtxt = txt | unicode::utf<SQLWCHAR>;
+            check(SQLPrepareW(stmt.get(), wtxt.data(), SQL_NTS), stmt);
+            ptr = &statements_.put(txt, std::move(stmt));
         }
+        auto& stmt = *ptr;
+        check(SQLFreeStmt(stmt.get(), SQL_RESET_PARAMS), stmt);
         auto ps = qry.params() | std::views::transform(params::make) |
                   std::ranges::to<std::vector>();
         for (size_t i{}; i < ps.size(); ++i)
-            params::bind(stmt_, SQLUSMALLINT(i + 1), ps[i]);
+            params::bind(stmt, SQLUSMALLINT(i + 1), ps[i]);
         check(SQLSetStmtAttr(  //
-                  stmt_.get(),
+                  stmt.get(),
                   SQL_ATTR_QUERY_TIMEOUT,
                   SQLPOINTER(std::chrono::seconds{timeout}.count()),
                   0),
-              stmt_);
-        auto ec = SQLExecute(stmt_.get());
-        for (; SQL_NO_DATA != ec; ec = SQLMoreResults(stmt_.get())) {
-            check(ec, stmt_);
-            ret = {};
-            SQLSMALLINT cols;
-            check(SQLNumResultCols(stmt_.get(), &cols), stmt_);
-            if (cols) {
-                for (int i{}; i < cols; ++i)
-                    ret.columns.push_back(name(stmt_, i + 1));
-                ec = SQLFetch(stmt_.get());
-                for (; SQL_NO_DATA != ec; ec = SQLFetch(stmt_.get())) {
-                    check(ec, stmt_);
-                    auto& row = ret.rows.emplace_back(cols);
-                    for (int i{}; i < cols; ++i)
-                        row[i] = get_data(stmt_, i + 1);
+              stmt);
+        auto _ = run(stmt);
+        auto ec = SQLExecute(stmt.get());
+        for (; SQL_NO_DATA != ec; ec = SQLMoreResults(stmt.get())) {
+            check(ec, stmt);
+            auto cur = block_cursor{stmt, getdata_};
+            ret = cur.fetch(SIZE_MAX);
+        }
+        return ret;
+    }
+
+    std::generator<db::rowset> exec_many(std::vector<db::query> qrys) override
+    {
+        for (auto& qry : qrys)
+            co_yield exec(qry);
+    }
+
+    std::generator<db::rowset> scan(db::query qry, size_t batch_size) override
+    {
+        return stream(std::move(qry), [=](block_cursor& cur) {
+            return cur.fetch(batch_size);
+        });
+    }
+
+    std::generator<db::column_batch> scan_columns(db::query qry,
+                                                  size_t batch_size) override
+    {
+        return stream(std::move(qry), [=](block_cursor& cur) {
+            return cur.fetch_columns(batch_size);
+        });
+    }
+
+    bool copy(db::query const&, db::rowset const&) override { return false; }
+
+    bool exec_batch(db::query const& qry, db::rowset const& rs) override
+    {
+        auto kinds = std::vector<size_t>(rs.columns.size());
+        for (auto& row : rs)
+            for (auto [kind, var] : std::views::zip(kinds, row))
+                if (var.has_value()) {
+                    if (kind && kind != var.index())
+                        return false;
+                    kind = var.index();
                 }
+        auto stmt = alloc<SQL_HANDLE_STMT>(dbc_);
+        auto txt = qry.text(id_quote_, param_mark()) | unicode::utf<SQLWCHAR>;
+        check(SQLPrepareW(stmt.get(), txt.data(), SQL_NTS), stmt);
+        for (auto rows : params::paramsets(rs.rows)) {
+            auto arrs = std::vector<params::array>{};
+            arrs.reserve(kinds.size());
+            for (size_t i{}; i < kinds.size(); ++i) {
+                auto& arr = arrs.emplace_back(params::make(rows, i, kinds[i]));
+                params::bind(stmt, SQLUSMALLINT(i + 1), arr);
             }
+            check(SQLSetStmtAttr(  //
+                      stmt.get(),
+                      SQL_ATTR_PARAMSET_SIZE,
+                      SQLPOINTER(rows.size()),
+                      0),
+                  stmt);
+            auto _ = run(stmt);
+            auto ec = SQLExecute(stmt.get());
+            for (; SQL_NO_DATA != ec; ec = SQLMoreResults(stmt.get()))
+                check(ec, stmt);
         }
-        return ret;
+        return true;
+    }
+
+    void cancel() override
+    {
+        auto lock = std::lock_guard{running_guard_};
+        if (running_)
+            SQLCancel(running_);
     }
 
+    void reset_statements() override { statements_.clear(); }
+
     void set_autocommit(bool on) override
     {
         if (on)
@@ -105,6 +169,42 @@ public:
     char id_quote() override { return id_quote_; }
     std::string param_mark() override { return "?"; }
     std::string dbms() override { return dbms_; }
+    auto const& statements() const { return statements_; }
+
+private:
+    /// batches fetched by f from a statement of its own
+    template <class F>
+    std::generator<std::invoke_result_t<F, block_cursor&>> stream(
+        db::query qry,
+        F f)
+    {
+        auto stmt = alloc<SQL_HANDLE_STMT>(dbc_);
+        auto txt = qry.text(id_quote_, param_mark()) | unicode::utf<SQLWCHAR>;
+        check(SQLPrepareW(stmt.get(), txt.data(), SQL_NTS), stmt);
+        auto ps = qry.params() | std::views::transform(params::make) |
+                  std::ranges::to<std::vector>();
+        for (size_t i{}; i < ps.size(); ++i)
+            params::bind(stmt, SQLUSMALLINT(i + 1), ps[i]);
+        auto _ = run(stmt);
+        check(SQLExecute(stmt.get()), stmt);
+        auto cur = block_cursor{stmt, getdata_};
+        for (;;) {
+            auto batch = f(cur);
+            if (batch.empty())
+                break;
+            co_yield std::move(batch);
+        }
+    }
+
+    auto run(stmt_ptr const& stmt)
+    {
+        auto lock = std::lock_guard{running_guard_};
+        running_ = stmt.get();
+        return finally{[this] {
+            auto lock = std::lock_guard{running_guard_};
+            running_ = {};
+        }};
+    }
 };
 
 }  // namespace boat::sql::odbc
@@ -0,0 +1,235 @@
+// Andrew Naplavkov
+
+#ifndef BOAT_SQL_ODBC_BLOCK_CURSOR_HPP
+#define BOAT_SQL_ODBC_BLOCK_CURSOR_HPP
+
+#include <boat/db/column_batch.hpp>
+#include <boat/sql/odbc/detail/get_data.hpp>
+#include <cstring>
+
+namespace boat::sql::odbc {
+
+constexpr SQLULEN block_rows = 1024;
+constexpr SQLULEN block_bytes = 1 << 22;
+constexpr SQLLEN max_bound_length = 1024;  //< longer values use SQLGetData
+
+/// describes result columns once and fetches column-wise arrays of rows,
+/// unbound columns are read with SQLGetData from the positioned row
+class block_cursor {
+    struct column {
+        SQLLEN type;           //< SQL_DESC_TYPE
+        SQLSMALLINT c_type{};  //< unbound if zero
+        SQLLEN width{};
+        std::vector<std::byte> data;
+        std::vector<SQLLEN> ind;
+    };
+
+    stmt_ptr const& stmt_;
+    std::vector<std::string> names_;
+    std::vector<column> cols_;
+    bool bound_{};    //< any column
+    bool unbound_{};  //< any column
+    SQLULEN rows_ = 1;
+    SQLULEN fetched_{};
+    SQLULEN pos_{};
+
+    static void describe(column& col, SQLLEN len)
+    {
+        switch (col.type) {
+            case SQL_BIGINT:
+            case SQL_BIT:
+            case SQL_INTEGER:
+            case SQL_SMALLINT:
+            case SQL_TINYINT:
+                col.c_type = SQL_C_SBIGINT;
+                col.width = sizeof(int64_t);
+                break;
+            case SQL_DECIMAL:
+            case SQL_DOUBLE:
+            case SQL_FLOAT:
+            case SQL_NUMERIC:
+            case SQL_REAL:
+                col.c_type = SQL_C_DOUBLE;
+                col.width = sizeof(double);
+                break;
+            case SQL_CHAR:
+            case SQL_VARCHAR:
+            case SQL_WCHAR:
+            case SQL_WVARCHAR:
+                if (len > 0 && len <= max_bound_length) {
+                    col.c_type = SQL_C_WCHAR;
+                    col.width = (2 * len + 1) * sizeof(SQLWCHAR);
+                }
+                break;
+            case SQL_BINARY:
+            case SQL_VARBINARY:
+                if (len > 0 && len <= max_bound_length) {
+                    col.c_type = SQL_C_BINARY;
+                    col.width = len;
+                }
+                break;
+        }
+    }
+
+    db::variant value(column const& col, SQLUSMALLINT num) const
+    {
+        if (!col.c_type)
+            return get_data(stmt_, num, col.type);
+        auto ind = col.ind[pos_];
+        if (ind == SQL_NULL_DATA)
+            return {};
+        boat::check(ind >= 0 && ind <= col.width, "odbc truncation");
+        auto ptr = col.data.data() + pos_ * col.width;
+        switch (col.c_type) {
+            case SQL_C_SBIGINT: {
+                int64_t ret;
+                std::memcpy(&ret, ptr, sizeof ret);
+                return ret;
+            }
+            case SQL_C_DOUBLE: {
+                double ret;
+                std::memcpy(&ret, ptr, sizeof ret);
+                return ret;
+            }
+            case SQL_C_WCHAR:
+                return std::span{reinterpret_cast<SQLWCHAR const*>(ptr),
+                                 ind / sizeof(SQLWCHAR)} |
+                       unicode::utf8;
+        }
+        return db::variant{std::in_place_type<blob>, ptr, size_t(ind)};
+    }
+
+    /// borrows bound binary values, buf holds converted ones
+    db::variant_view view(column const& col,
+                          SQLUSMALLINT num,
+                          db::variant& buf) const
+    {
+        if (col.c_type != SQL_C_BINARY) {
+            buf = value(col, num);
+            return db::borrow(buf);
+        }
+        auto ind = col.ind[pos_];
+        if (ind == SQL_NULL_DATA)
+            return {};
+        boat::check(ind >= 0 && ind <= col.width, "odbc truncation");
+        return blob_view{col.data.data() + pos_ * col.width, size_t(ind)};
+    }
+
+    /// positions on the next row, false at the end of result
+    bool next()
+    {
+        if (cols_.empty())
+            return false;
+        if (pos_ == fetched_) {
+            auto ec = SQLFetch(stmt_.get());
+            if (SQL_NO_DATA == ec)
+                return false;
+            check(ec, stmt_);
+            pos_ = 0;
+            if (!bound_)
+                fetched_ = 1;
+            if (!fetched_)
+                return false;
+        }
+        if (unbound_ && rows_ > 1)
+            check(SQLSetPos(stmt_.get(),
+                            SQLSETPOSIROW(pos_ + 1),
+                            SQL_POSITION,
+                            SQL_LOCK_NO_CHANGE),
+                  stmt_);
+        return true;
+    }
+
+public:
+    /// getdata is SQL_GETDATA_EXTENSIONS of the driver
+    block_cursor(stmt_ptr const& stmt, SQLUINTEGER getdata = 0) : stmt_{stmt}
+    {
+        SQLSMALLINT cols;
+        check(SQLNumResultCols(stmt.get(), &cols), stmt);
+        cols_.resize(cols);
+        auto row_width = SQLULEN{};
+        for (SQLUSMALLINT i{}; i < cols; ++i) {
+            auto& col = cols_[i];
+            SQLLEN len;
+            names_.push_back(name(stmt, i + 1));
+            check(SQLColAttribute(
+                      stmt.get(), i + 1, SQL_DESC_TYPE, 0, 0, 0, &col.type),
+                  stmt);
+            check(SQLColAttribute(
+                      stmt.get(), i + 1, SQL_DESC_LENGTH, 0, 0, 0, &len),
+                  stmt);
+            describe(col, len);
+            if (unbound_ && !(getdata & SQL_GD_ANY_ORDER))
+                col = {.type = col.type};  //< SQLGetData after bound columns
+            bound_ = bound_ || col.c_type;
+            unbound_ = unbound_ || !col.c_type;
+            row_width += col.width + sizeof(SQLLEN);
+        }
+        if (!bound_)
+            return;
+        if (!unbound_ || getdata & SQL_GD_BLOCK)
+            rows_ = std::clamp<SQLULEN>(block_bytes / row_width, 1, block_rows);
+        for (SQLUSMALLINT i{}; i < cols; ++i) {
+            auto& col = cols_[i];
+            if (!col.c_type)
+                continue;
+            col.data.resize(rows_ * col.width);
+            col.ind.resize(rows_);
+            check(SQLBindCol(  //
+                      stmt.get(),
+                      i + 1,
+                      col.c_type,
+                      col.data.data(),
+                      col.width,
+                      col.ind.data()),
+                  stmt);
+        }
+        check(SQLSetStmtAttr(
+                  stmt.get(), SQL_ATTR_ROW_ARRAY_SIZE, SQLPOINTER(rows_), 0),
+              stmt);
+        check(SQLSetStmtAttr(
+                  stmt.get(), SQL_ATTR_ROWS_FETCHED_PTR, &fetched_, 0),
+              stmt);
+    }
+
+    block_cursor(block_cursor const&) = delete;
+    block_cursor& operator=(block_cursor const&) = delete;
+
+    ~block_cursor()
+    {
+        if (!bound_)
+            return;
+        SQLSetStmtAttr(stmt_.get(), SQL_ATTR_ROWS_FETCHED_PTR, 0, 0);
+        SQLSetStmtAttr(stmt_.get(), SQL_ATTR_ROW_ARRAY_SIZE, SQLPOINTER(1), 0);
+        SQLFreeStmt(stmt_.get(), SQL_UNBIND);
+    }
+
+    /// empty at the end of result
+    db::rowset fetch(size_t limit)
+    {
+        auto ret = db::rowset{.columns = names_};
+        for (; ret.rows.size() < limit && next(); ++pos_) {
+            auto& row = ret.rows.emplace_back(cols_.size());
+            for (SQLUSMALLINT i{}; i < cols_.size(); ++i)
+                row[i] = value(cols_[i], i + 1);
+        }
+        return ret;
+    }
+
+    /// same as above, bound binary values go from the arrays to the arenas
+    db::column_batch fetch_columns(size_t limit)
+    {
+        auto ret = db::column_batch{};
+        for (auto& name : names_)
+            ret.columns.emplace_back().name = name;
+        auto buf = db::variant{};
+        for (size_t rows{}; rows < limit && next(); ++rows, ++pos_)
+            for (SQLUSMALLINT i{}; i < cols_.size(); ++i)
+                ret.columns[i].push_back(view(cols_[i], i + 1, buf));
+        return ret;
+    }
+};
+
+}  // namespace boat::sql::odbc
+
+#endif  // BOAT_SQL_ODBC_BLOCK_CURSOR_HPP
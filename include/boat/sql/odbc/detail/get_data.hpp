@@ -61,11 +61,11 @@ inline db::variant get_blob(stmt_ptr const& stmt, SQLUSMALLINT col)
     return val;
 }
 
-inline db::variant get_data(stmt_ptr const& stmt, SQLUSMALLINT col)
+inline db::variant get_data(  //
+    stmt_ptr const& stmt,
+    SQLUSMALLINT col,
+    SQLLEN type)  //< SQL_DESC_TYPE
 {
-    SQLLEN type;
-    check(SQLColAttribute(stmt.get(), col, SQL_DESC_TYPE, 0, 0, 0, &type),
-          stmt);
     switch (type) {
         case SQL_BIGINT:
         case SQL_BIT:
@@ -5,6 +5,7 @@
 
 #include <boat/db/adapted/adapted.hpp>
 #include <boat/sql/odbc/detail/utility.hpp>
+#include <cstring>
 #include <variant>
 
 namespace boat::sql::odbc::params {
@@ -64,6 +65,134 @@ inline param make(db::variant const& var)
     return std::visit(vis, var);
 }
 
+constexpr SQLULEN paramset_size = 4096;
+constexpr size_t paramset_bytes = 1 << 24;  //< caps the arrays of a set
+
+/// column-wise values of a parameter set
+struct array {
+    SQLSMALLINT c_type = SQL_C_WCHAR;
+    SQLSMALLINT sql_type = SQL_WVARCHAR;
+    SQLULEN size = 1;
+    SQLLEN width = sizeof(SQLWCHAR);
+    std::vector<std::byte> data;
+    std::vector<SQLLEN> ind;
+};
+
+/// kind is the variant index shared by non-null values of the column
+inline array make(range_of<std::vector<db::variant>> auto&& rows,
+                  size_t col,
+                  size_t kind)
+{
+    auto ret = array{};
+    auto vals = rows | std::views::transform([col](auto& row) -> auto& {
+                    return row[col];
+                });
+    auto strs = std::vector<std::basic_string<SQLWCHAR>>{};
+    switch (kind) {
+        case variant_index<db::variant_base, int64_t>():
+            ret.c_type = SQL_C_SBIGINT;
+            ret.sql_type = SQL_BIGINT;
+            ret.width = sizeof(int64_t);
+            break;
+        case variant_index<db::variant_base, double>():
+            ret.c_type = SQL_C_DOUBLE;
+            ret.sql_type = SQL_DOUBLE;
+            ret.width = sizeof(double);
+            break;
+        case variant_index<db::variant_base, std::string>():
+            for (auto& var : vals) {
+                auto str = std::get_if<std::string>(&var);
+                auto& wstr = strs.emplace_back();
+                if (str)
+                    wstr = *str | unicode::utf<SQLWCHAR>;
+                ret.size = std::max<SQLULEN>(ret.size, wstr.size());
+            }
+            ret.width = (ret.size + 1) * sizeof(SQLWCHAR);
+            break;
+        case variant_index<db::variant_base, blob>():
+            ret.c_type = SQL_C_BINARY;
+            ret.sql_type = SQL_VARBINARY;
+            for (auto& var : vals)
+                if (auto bin = std::get_if<blob>(&var))
+                    ret.size = std::max<SQLULEN>(ret.size, bin->size());
+            ret.width = ret.size;
+            break;
+    }
+    ret.data.resize(std::ranges::distance(vals) * ret.width);
+    for (size_t row{}; auto& var : vals) {
+        auto ptr = ret.data.data() + row * ret.width;
+        auto& ind = ret.ind.emplace_back();
+        auto vis = overloaded{
+            [&](db::null) { ind = SQL_NULL_DATA; },
+            [&](arithmetic auto v) { std::memcpy(ptr, &v, sizeof v); },
+            [&](std::string const&) {
+                ind = strs[row].size() * sizeof(SQLWCHAR);
+                std::memcpy(ptr, strs[row].data(), ind);
+            },
+            [&](blob const& v) {
+                ind = v.size();
+                std::memcpy(ptr, v.data(), ind);
+            }};
+        std::visit(vis, var);
+        ++row;
+    }
+    return ret;
+}
+
+/// upper bound of the array width the value needs
+inline size_t width(db::variant const& var)
+{
+    constexpr auto vis = overloaded{
+        [](db::null) { return 0uz; },
+        [](arithmetic auto v) { return sizeof v; },
+        [](std::string const& v) { return (v.size() + 1) * sizeof(SQLWCHAR); },
+        [](blob const& v) { return v.size(); },
+    };
+    return std::visit(vis, var);
+}
+
+/// splits rows so that every column array of a set is the widest value
+/// times the number of rows, within paramset_bytes in total
+inline auto paramsets(std::span<std::vector<db::variant> const> rows)
+{
+    auto ret = std::vector<decltype(rows)>{};
+    auto widths = std::vector<size_t>{};
+    auto first = 0uz;
+    for (auto i = 0uz; i < rows.size(); ++i) {
+        widths.resize(rows[i].size());
+        auto sum = 0uz;
+        for (auto [w, var] : std::views::zip(widths, rows[i]))
+            sum += std::max<>(w, width(var));
+        auto n = i - first + 1;
+        if (n > 1 && (n > paramset_size || n * sum > paramset_bytes)) {
+            ret.push_back(rows.subspan(first, i - first));
+            first = i;
+            std::ranges::fill(widths, 0uz);
+        }
+        for (auto [w, var] : std::views::zip(widths, rows[i]))
+            w = std::max<>(w, width(var));
+    }
+    if (first < rows.size())
+        ret.push_back(rows.subspan(first));
+    return ret;
+}
+
+inline void bind(stmt_ptr const& stmt, SQLUSMALLINT i, array& arr)
+{
+    check(SQLBindParameter(  //
+              stmt.get(),
+              i,
+              SQL_PARAM_INPUT,
+              arr.c_type,
+              arr.sql_type,
+              arr.size,
+              0,
+              arr.data.data(),
+              arr.width,
+              arr.ind.data()),
+          stmt);
+}
+
 inline void bind(stmt_ptr const& stmt, SQLUSMALLINT i, param& p)
 {
     std::visit(
@@ -4,6 +4,7 @@
 #define BOAT_SQL_SQLITE_COMMAND_HPP
 
 #include <boat/db/command.hpp>
+#include <boat/detail/string.hpp>
 #include <boat/sql/sqlite/detail/utility.hpp>
 #include <filesystem>
 
@@ -12,19 +13,24 @@ namespace boat::sql::sqlite {
 class command : public db::command {
     unique_ptr<sqlite3, sqlite3_close_v2> dbc_;
     unique_ptr<void, spatialite_cleanup_ex> spatial_;
+    std::string pragmas_;  //< restored after bulk load
 
 public:
-    explicit command(char const* file)
+    /// read-only connections to the same file can query it in parallel
+    explicit command(char const* file, bool read_only = false)
     {
-        constexpr int flags =
-            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+        int flags = SQLITE_OPEN_NOMUTEX;
+        flags |= read_only ? SQLITE_OPEN_READONLY
+                           : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
         auto exists = std::filesystem::exists(file);
         sqlite3* dbc;
         check(sqlite3_open_v2(file, &dbc, flags, 0), dbc_);
         dbc_.reset(dbc);
         spatial_.reset(spatialite_alloc_connection());
         spatialite_init_ex(dbc_.get(), spatial_.get(), 0);
-        if (!exists)
+        if (read_only)
+            exec(concat("pragma mmap_size = ", mmap_size, ";"));
+        else if (!exists)
             try {
                 exec("SELECT InitSpatialMetaData(1)");
             }
@@ -65,11 +71,146 @@ public:
         return ret;
     }
 
-    void set_autocommit(bool on) override { exec(on ? "rollback;" : "begin;"); }
+    std::generator<db::rowset> exec_many(std::vector<db::query> qrys) override
+    {
+        for (auto& qry : qrys)
+            co_yield exec(qry);
+    }
+
+    void visit(std::vector<db::query> qrys, db::row_visitor const& f) override
+    {
+        auto row = std::vector<db::variant_view>{};
+        for (size_t i{}; i < qrys.size(); ++i) {
+            auto stmt = prepare(qrys[i]);
+            row.resize(sqlite3_column_count(stmt.get()));
+            int ec = sqlite3_step(stmt.get());
+            for (; SQLITE_DONE != ec; ec = sqlite3_step(stmt.get())) {
+                check(ec, dbc_);
+                for (int col{}; col < int(row.size()); ++col)
+                    row[col] = column_view(stmt.get(), col);
+                f(i, row);
+            }
+        }
+    }
+
+    std::generator<db::rowset> scan(db::query qry, size_t batch_size) override
+    {
+        auto ptr = prepare(qry);
+        auto stmt = ptr.get();
+        int cols = sqlite3_column_count(stmt);
+        auto ret = db::rowset{};
+        ret.columns.resize(cols);
+        for (int i{}; i < cols; ++i)
+            ret.columns[i] = sqlite3_column_name(stmt, i);
+        int ec = sqlite3_step(stmt);
+        for (; SQLITE_DONE != ec; ec = sqlite3_step(stmt)) {
+            check(ec, dbc_);
+            auto& row = ret.rows.emplace_back(cols);
+            for (int i{}; i < cols; ++i)
+                row[i] = column_value(stmt, i);
+            if (ret.rows.size() == batch_size)
+                co_yield std::exchange(ret, {.columns = ret.columns});
+        }
+        if (!ret.empty())
+            co_yield std::move(ret);
+    }
+
+    std::generator<db::column_batch> scan_columns(db::query qry,
+                                                  size_t batch_size) override
+    {
+        auto ptr = prepare(qry);
+        auto stmt = ptr.get();
+        int cols = sqlite3_column_count(stmt);
+        auto ret = db::column_batch{};
+        for (int i{}; i < cols; ++i)
+            ret.columns.emplace_back().name = sqlite3_column_name(stmt, i);
+        int ec = sqlite3_step(stmt);
+        for (; SQLITE_DONE != ec; ec = sqlite3_step(stmt)) {
+            check(ec, dbc_);
+            for (int i{}; i < cols; ++i)
+                ret.columns[i].push_back(column_view(stmt, i));
+            if (ret.size() == batch_size)
+                co_yield std::exchange(ret, ret.header());
+        }
+        if (!ret.empty())
+            co_yield std::move(ret);
+    }
+
+    bool copy(db::query const&, db::rowset const&) override { return false; }
+
+    bool exec_batch(db::query const& qry, db::rowset const& params) override
+    {
+        auto ptr = prepare(qry);
+        auto stmt = ptr.get();
+        auto load = [&] {
+            for (auto& row : params) {
+                int pos{};
+                for (auto& var : row)
+                    check(bind_value(stmt, ++pos, var), dbc_);
+                check(sqlite3_step(stmt), dbc_);
+                check(sqlite3_reset(stmt), dbc_);
+            }
+        };
+        if (!sqlite3_get_autocommit(dbc_.get()))
+            load();
+        else
+            try {
+                exec("begin;");
+                load();
+                exec("commit;");
+            }
+            catch (...) {
+                sqlite3_exec(dbc_.get(), "rollback;", 0, 0, 0);
+                throw;
+            }
+        return true;
+    }
+
+    void cancel() override { sqlite3_interrupt(dbc_.get()); }
+
+    /// bulk load mode while autocommit is off
+    void set_autocommit(bool on) override
+    {
+        if (on) {
+            exec("rollback;");
+            exec(std::exchange(pragmas_, {}));
+            return;
+        }
+        auto get = [&](char const* pragma) {
+            return exec(concat("pragma ", pragma, ";")).value();
+        };
+        auto mode = db::get<std::string>(get("journal_mode"));
+        pragmas_ = concat("pragma journal_mode = ",
+                          mode,
+                          ";pragma synchronous = ",
+                          db::get<int64_t>(get("synchronous")),
+                          ";pragma cache_size = ",
+                          db::get<int64_t>(get("cache_size")),
+                          ";");
+        exec(concat("pragma journal_mode = ",
+                    mode == "wal" ? "wal" : "memory",
+                    ";pragma synchronous = off"
+                    ";pragma cache_size = -65536"
+                    ";begin;"));
+    }
+
     void commit() override { exec("commit;begin;"); }
     char id_quote() override { return '"'; }
     std::string param_mark() override { return "?"; }
     std::string dbms() override { return "sqlite"; }
+
+private:
+    unique_ptr<sqlite3_stmt, sqlite3_finalize> prepare(db::query const& qry)
+    {
+        auto const txt = qry.text(id_quote(), param_mark());
+        sqlite3_stmt* stmt;
+        check(sqlite3_prepare_v2(dbc_.get(), txt.data(), -1, &stmt, 0), dbc_);
+        auto ret = unique_ptr<sqlite3_stmt, sqlite3_finalize>{stmt};
+        int pos{};
+        for (auto p : qry.params())
+            check(bind_value(stmt, ++pos, p), dbc_);
+        return ret;
+    }
 };
 
 }  // namespace boat::sql::sqlite
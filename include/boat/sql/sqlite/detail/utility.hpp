@@ -10,6 +10,8 @@
 
 namespace boat::sql::sqlite {
 
+constexpr auto mmap_size = 1ll << 30;  //< shared os page cache for readers
+
 void check(int ec, auto& dbc)
     requires requires { sqlite3_errmsg(dbc.get()); }
 {
@@ -40,6 +42,27 @@ inline int bind_value(sqlite3_stmt* stmt, int i, db::variant const& var)
     return std::visit(vis, var);
 }
 
+/// payload is valid until the next step
+inline db::variant_view column_view(sqlite3_stmt* stmt, int col)
+{
+    auto type = sqlite3_column_type(stmt, col);
+    switch (type) {
+        case SQLITE_NULL:
+            return {};
+        case SQLITE_INTEGER:
+            return sqlite3_column_int64(stmt, col);
+        case SQLITE_FLOAT:
+            return sqlite3_column_double(stmt, col);
+        case SQLITE_TEXT:
+            return std::string_view{as_chars(sqlite3_column_text(stmt, col)),
+                                    size_t(sqlite3_column_bytes(stmt, col))};
+        case SQLITE_BLOB:
+            return blob_view{as_bytes(sqlite3_column_blob(stmt, col)),
+                             size_t(sqlite3_column_bytes(stmt, col))};
+    }
+    throw std::runtime_error{concat(sqlite3_column_name(stmt, col), " ", type)};
+}
+
 inline db::variant column_value(sqlite3_stmt* stmt, int col)
 {
     auto type = sqlite3_column_type(stmt, col);
@@ -1,6 +1,7 @@
 //< Andrew Naplavkov
 
 #include <boat/gui/caches/lru.hpp>
+#include <boat/sql/detail/statements.hpp>
 #include <boost/test/unit_test.hpp>
 
 BOOST_AUTO_TEST_CASE(cache)
@@ -16,3 +17,19 @@ BOOST_AUTO_TEST_CASE(cache)
     BOOST_CHECK_EQUAL(std::any_cast<int>(lru.get(3)), 3);  //< {4:4, 3:3}
     BOOST_CHECK_EQUAL(std::any_cast<int>(lru.get(4)), 4);  //< {3:3, 4:4}
 }
+
+BOOST_AUTO_TEST_CASE(cache_statements)
+{
+    auto cache = boat::sql::statement_cache<size_t>{};
+    for (auto i = 0uz; i <= boat::statement_cache_size; ++i)
+        cache.put(std::to_string(i), i);
+    BOOST_CHECK_EQUAL(cache.size(), boat::statement_cache_size);
+    BOOST_CHECK(!cache.find("0"));  //< evicted
+    BOOST_CHECK_EQUAL(*cache.find("1"), 1u);
+    BOOST_CHECK(cache.evict());  //< "2" is the least recently used now
+    BOOST_CHECK(!cache.find("2"));
+    BOOST_CHECK_EQUAL(cache.hits(), 1u);
+    BOOST_CHECK_EQUAL(cache.misses(), 2u);
+    cache.clear();
+    BOOST_CHECK(!cache.find("1"));
+}
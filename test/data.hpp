@@ -58,7 +58,9 @@ inline void check(boat::db::catalog& cat)
     cat.drop(tbl.schema_name, tbl.table_name);
     tbl = cat.create(tbl);
     std::cout << tbl;
-    cat.insert(tbl, db::to_rowset(objs));
+    BOOST_CHECK(!objs.front().sample);  //< a batch of a null column only
+    cat.insert(tbl, db::to_rowset(objs | std::views::take(1)));
+    cat.insert(tbl, db::to_rowset(objs | std::views::drop(1)));
 
     auto bbox = db::bbox{
         .select_list{std::string(boost::pfr::get_name<0, udt>())},
@@ -70,6 +72,24 @@ inline void check(boat::db::catalog& cat)
     };
     BOOST_CHECK(std::ranges::equal(std::array{2},
                                    cat.select(tbl, bbox) | db::view<int>));
+    auto matches = 0;
+    for (auto&& rs : cat.select(tbl, std::vector{bbox, bbox}))
+        matches += std::ranges::equal(std::array{2}, rs | db::view<int>);
+    BOOST_CHECK_EQUAL(matches, 2);
+
+    auto sample = db::bbox{
+        .select_list{std::string(boost::pfr::get_name<2, udt>())},
+        .xmin = 0,
+        .ymin = 0,
+        .xmax = 50,
+        .ymax = 50,
+        .limit = int(objs.size()),
+        .sample = 1,
+        .simplify_tolerance = 1,
+    };
+    auto rs = cat.select(tbl, sample);
+    BOOST_CHECK_EQUAL(rs.rows.size(), 1u);
+    BOOST_CHECK(std::holds_alternative<blob>(rs.value()));
 
     auto page = db::page{
         .select_list = boost::pfr::names_as_array<udt>() |
@@ -81,6 +101,35 @@ inline void check(boat::db::catalog& cat)
         res.append_range(cat.select(tbl, page) | db::view<udt>);
     BOOST_CHECK(
         std::ranges::equal(objs, res, BOAT_LIFT(boost::pfr::eq_fields)));
+
+    res.clear();
+    for (page.offset = 0;; page.after = {db::to_variant(res.back().id)}) {
+        auto rs = cat.select(tbl, page);
+        if (rs.empty())
+            break;
+        res.append_range(rs | db::view<udt>);
+    }
+    BOOST_CHECK(
+        std::ranges::equal(objs, res, BOAT_LIFT(boost::pfr::eq_fields)));
+
+    res.clear();
+    auto batches = 0uz;
+    for (auto&& rs : cat.scan(tbl, page.select_list, 1)) {
+        BOOST_CHECK_EQUAL(rs.rows.size(), 1u);
+        res.append_range(rs | db::view<udt>);
+        ++batches;
+    }
+    BOOST_CHECK_EQUAL(batches, objs.size());
+    std::ranges::sort(res, {}, &udt::id);
+    BOOST_CHECK(
+        std::ranges::equal(objs, res, BOAT_LIFT(boost::pfr::eq_fields)));
+
+    res.clear();
+    for (auto&& cb : cat.scan_columns(tbl, page.select_list, 1))
+        res.append_range(cb.rows() | db::view<udt>);
+    std::ranges::sort(res, {}, &udt::id);
+    BOOST_CHECK(
+        std::ranges::equal(objs, res, BOAT_LIFT(boost::pfr::eq_fields)));
 }
 
 #endif  // BOAT_TEST_DATA_HPP
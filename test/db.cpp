@@ -1,5 +1,6 @@
 // Andrew Naplavkov
 
+#include <boat/db/column_batch.hpp>
 #include <boost/test/unit_test.hpp>
 #include "data.hpp"
 
@@ -17,3 +18,35 @@ BOOST_AUTO_TEST_CASE(db)
         std::bind_front(&decltype(std::cout)::imbue, &std::cout), locale};
     std::cout << std::fixed << std::setprecision(2) << rs << "\n";
 }
+
+BOOST_AUTO_TEST_CASE(db_column_batch)
+{
+    auto objs = get_objects();
+    auto cb = boat::db::to_column_batch(objs);
+    BOOST_CHECK_EQUAL(cb.size(), objs.size());
+    BOOST_CHECK(std::ranges::equal(  //
+        objs,
+        cb.rows() | boat::db::view<udt>,
+        BOAT_LIFT(boost::pfr::eq_fields)));
+    auto rs = boat::db::to_rowset(objs);
+    BOOST_CHECK(boat::db::to_rowset(boat::db::to_column_batch(rs)).rows ==
+                rs.rows);
+    auto col = boat::db::to_column(
+        "geom",
+        boat::geometry::to_wkb_arena(objs | std::views::transform(&udt::geom)));
+    BOOST_CHECK_EQUAL(col.size(), objs.size());
+    for (auto [i, obj] : std::views::enumerate(objs))
+        BOOST_CHECK(col.value(i) == boat::db::to_variant(obj.geom));
+    cb = {};
+    cb.columns.resize(1);
+    cb.push_back(std::vector{boat::db::variant{}});
+    cb.push_back(std::vector<boat::db::variant>{1});
+    cb.push_back(std::vector<boat::db::variant>{.5});
+    BOOST_CHECK(!cb.value().has_value());
+    BOOST_CHECK_EQUAL(boat::db::get<double>(cb.columns[0].value(1)), 1.);
+    cb.push_back(std::vector<boat::db::variant>{"x"});  //< dynamic typing
+    BOOST_CHECK_EQUAL(cb.columns[0].index, cb.columns[0].mixed);
+    BOOST_CHECK(boat::db::to_rowset(cb).rows ==
+                (std::vector<std::vector<boat::db::variant>>{
+                    {boat::db::variant{}}, {1.}, {.5}, {"x"}}));
+}
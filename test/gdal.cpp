@@ -51,6 +51,8 @@ BOOST_AUTO_TEST_CASE(gdal_vector)
         else
             cat.dataset = boat::gdal::create(path.data(), driver.data());
         check(cat);
+        BOOST_CHECK_THROW(cat.get_table("", "drop_unknown_layer"),
+                          std::runtime_error);
     }
 }
 
@@ -90,6 +92,10 @@ BOOST_AUTO_TEST_CASE(gdal_raster)
         BOOST_CHECK_EQUAL(img2.size(), tiles.size());
         for (auto& tile : tiles)
             BOOST_CHECK(img1.at(tile) == img2.at(tile));
+        cat2.build_overviews(rast2);
+        BOOST_CHECK_EQUAL(
+            GDALGetOverviewCount(GDALGetRasterBand(cat2.dataset.get(), 1)),
+            boat::gdal::overview_factors(rast2.width, rast2.height).size());
     }
 }
 
@@ -1,11 +1,14 @@
 // Andrew Naplavkov
 
 #include <boat/geometry/raster.hpp>
-#include <boat/geometry/wkb.hpp>
+#include <boat/geometry/wkb_view.hpp>
+#include <boat/gui/detail/geometry.hpp>
+#include <boat/gui/detail/gil.hpp>
 #include <boost/algorithm/hex.hpp>
 #include <boost/fusion/algorithm.hpp>
 #include <boost/fusion/container.hpp>
 #include <boost/test/unit_test.hpp>
+#include <iostream>
 #include "utility.hpp"
 
 using namespace boat::geometry;
@@ -64,6 +67,70 @@ BOOST_AUTO_TEST_CASE(geometry_transform_wkb)
     });
 }
 
+BOOST_AUTO_TEST_CASE(geometry_transform_points)
+{
+    namespace geo = boat::geometry;
+    auto fwd = srs_forward(transformation(crs));
+    auto inv = srs_inverse(transformation(crs));
+    auto aff = affine(width, height, cartesian::box{{-1e7, -1e7}, {1e7, 1e7}});
+    auto mat = mat_inverse(aff);
+    auto ll = from_wkt<geographic::multi_point>(
+        "MULTIPOINT((10 40),(40 30),(20 20),(30 10))");
+    auto px = ll;
+    BOOST_CHECK(transform_points(px, fwd, mat));
+    for (auto [a, b] : std::views::zip(ll, px))
+        BOOST_CHECK_EQUAL(to_wkt(*geo::transform(fwd, mat)(a)), to_wkt(b));
+    auto wkt = "GEOMETRYCOLLECTION(POINT(40 10),"
+               "POLYGON((40 40,20 45,45 30,40 40)))"s;
+    auto geom = from_wkt<geographic::variant>(wkt);
+    auto back = geo::transform(fwd, mat, mat_forward(aff), inv)(geom);
+    BOOST_CHECK(back && to_wkt(*back) == wkt);
+}
+
+BOOST_AUTO_TEST_CASE(geometry_approximate)
+{
+    auto mercator =
+        affine(width, height, cartesian::box{{-2e7, -2e7}, {2e7, 2e7}});
+    auto globe =
+        affine(width, height, cartesian::box{{-7e6, -7e6}, {7e6, 7e6}});
+    auto [fwd, inv] = boat::gui::bidirectional(
+        mercator, crs, globe, ortho(geographic::point{30, 50}));
+    auto x = 800, y = 400, w = 256, h = 128;
+    auto src = std::vector<geographic::point>(w * h);
+    boat::gui::approximate(inv, x, y, w, h, src);
+    auto worst = 0.;
+    for (auto r = 0; r < h; ++r)
+        for (auto c = 0; c < w; ++c) {
+            auto p = inv(geographic::point(x + c, y + r));
+            auto& q = src[r * w + c];
+            BOOST_REQUIRE(p);
+            worst = std::max<>(worst,
+                               std::hypot(p->x() - q.x(), p->y() - q.y()));
+        }
+    BOOST_CHECK_LT(worst, .5);
+}
+
+BOOST_AUTO_TEST_CASE(geometry_resample)
+{
+    using pixel = boost::gil::rgba8_pixel_t;
+    auto img = boost::gil::rgba8_image_t{2, 1};
+    view(img)(0, 0) = pixel{0, 0, 0, 255};
+    view(img)(1, 0) = pixel{200, 100, 50, 255};
+    auto src = std::vector<geographic::point>{
+        {.5, .5}, {1., .5}, {1.5, .5}, {2., .5}, {NAN, NAN}};
+    auto out = std::vector<pixel>(src.size());
+    boat::gui::resample(const_view(img), src, out.data());
+    BOOST_CHECK(out[1] == view(img)(1, 0));
+    BOOST_CHECK(out[3] == pixel{});
+    BOOST_CHECK(out[4] == pixel{});
+    boat::gui::resample(
+        const_view(img), src, out.data(), boat::gui::filter::bilinear);
+    BOOST_CHECK(out[0] == view(img)(0, 0));
+    BOOST_CHECK(out[1] == (pixel{100, 50, 25, 255}));
+    BOOST_CHECK(out[2] == view(img)(1, 0));
+    BOOST_CHECK(out[4] == pixel{});
+}
+
 BOOST_AUTO_TEST_CASE(geometry_endian)
 {
     std::pair<std::string, std::string> tests[] = {
@@ -78,6 +145,57 @@ BOOST_AUTO_TEST_CASE(geometry_endian)
     }
 }
 
+BOOST_AUTO_TEST_CASE(geometry_wkb_view)
+{
+    // clang-format off
+    for (auto wkt : {
+             "POINT(2 4)"s,
+             "LINESTRING(30 10,10 30,40 40)"s,
+             "POLYGON((35 10,45 45,15 40,10 20,35 10),(20 30,35 35,30 20,20 30))"s,
+             "MULTIPOLYGON(((40 40,20 45,45 30,40 40)),((20 35,10 30,10 10,30 5,45 20,20 35)))"s,
+             "GEOMETRYCOLLECTION(POINT(40 10),LINESTRING(10 10,20 20,10 40))"s,
+         }) {
+        // clang-format on
+        auto geom = from_wkt<cartesian::variant>(wkt);
+        auto wkb = boat::blob{} << geom;
+        auto view = wkb_view{wkb};
+        BOOST_CHECK_EQUAL(view.index(), geom.index());
+        BOOST_CHECK_EQUAL(boat::geometry::detail::wkb_extent(wkb), wkb.size());
+        auto n = 0uz;
+        for_each_point(view, [&](auto const&) { ++n; });
+        BOOST_CHECK_EQUAL(n, num_points(geom));
+        BOOST_CHECK(equals(envelope(view), minmax(geom)));
+    }
+    auto line = from_wkt<cartesian::linestring>("LINESTRING(0 0,3 4,3 0)");
+    auto wkb = boat::blob{} << line;
+    BOOST_CHECK_EQUAL(length(wkb_view{wkb}.points()), length(line));
+    auto unhex = boost::algorithm::unhex(
+        "000000000140000000000000004010000000000000"s);  //< big endian
+    auto pt = boat::blob_view{std::as_bytes(std::span(unhex))};
+    BOOST_CHECK(
+        equals(envelope(wkb_view{pt}), cartesian::box{{2, 4}, {2, 4}}));
+}
+
+BOOST_AUTO_TEST_CASE(geometry_wkb_arena)
+{
+    auto geoms = std::vector{
+        from_wkt<cartesian::variant>("POINT(2 4)"),
+        from_wkt<cartesian::variant>("LINESTRING(30 10,10 30,40 40)"),
+        from_wkt<cartesian::variant>(
+            "GEOMETRYCOLLECTION(POINT(40 10),POLYGON((0 0,1 0,1 1,0 0)))"),
+    };
+    auto arena = to_wkb_arena(geoms);
+    BOOST_CHECK_EQUAL(arena.size(), geoms.size());
+    for (auto [i, geom] : std::views::enumerate(geoms)) {
+        auto wkb = boat::blob{} << geom;
+        BOOST_CHECK_EQUAL(wkb_size(geom), wkb.size());
+        BOOST_CHECK(arena[i] == boat::blob_view{wkb});
+        auto buf = boat::blob(wkb.size() + 1, std::byte{});
+        BOOST_CHECK_EQUAL(write(geom, buf).size(), 1u);
+        BOOST_CHECK(buf.starts_with(wkb));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(geometry_fibonacci_monotonic)
 {
     auto lim = 50;
@@ -143,3 +261,86 @@ BOOST_AUTO_TEST_CASE(geometry_raster)
         }
     }
 }
+
+namespace {
+
+/// ring of n points encoded in native and swapped byte order
+auto wkb_ring(size_t n)
+{
+    namespace detail = boat::geometry::detail;
+    auto mbr = cartesian::box{{}, {1., 1.}};
+    auto poly = cartesian::polygon{};
+    for (auto& p : box_border_interpolate(mbr, n))
+        poly.outer().push_back(p);
+    poly.outer().push_back(poly.outer().front());
+    auto size = static_cast<uint32_t>(poly.outer().size());
+    auto native = boat::blob{} << poly;
+    auto swapped = boat::blob{} << uint8_t(!detail::native)
+                                << boat::byteswap(uint32_t{3})
+                                << boat::byteswap(uint32_t{1})
+                                << boat::byteswap(size);
+    for (auto& p : poly.outer())
+        swapped << boat::byteswap(p.x()) << boat::byteswap(p.y());
+    return std::tuple{std::move(poly), std::move(native), std::move(swapped)};
+}
+
+/// reference decoder
+cartesian::polygon per_point(boat::blob_view wkb)
+{
+    auto e = boat::geometry::detail::endians.at(boat::get<uint8_t>(wkb));
+    auto ret = cartesian::polygon{};
+    boat::check(boat::get<uint32_t>(wkb, e) == 3, "polygon");
+    for (auto i = boat::get<uint32_t>(wkb, e); i--;) {
+        auto& ring =
+            ret.outer().empty() ? ret.outer() : ret.inners().emplace_back();
+        for (auto j = boat::get<uint32_t>(wkb, e); j--;) {
+            auto x = boat::get<double>(wkb, e);
+            ring.emplace_back(x, boat::get<double>(wkb, e));
+        }
+    }
+    return ret;
+}
+
+cartesian::polygon bulk(boat::blob_view wkb)
+{
+    auto ret = cartesian::polygon{};
+    wkb >> ret;
+    return ret;
+}
+
+bool same_outer(cartesian::polygon const& lhs, cartesian::polygon const& rhs)
+{
+    return std::ranges::equal(lhs.outer(), rhs.outer(), [](auto& a, auto& b) {
+        return a.x() == b.x() && a.y() == b.y();
+    });
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(geometry_wkb_bulk)
+{
+    auto [poly, native, swapped] = wkb_ring(100);
+    for (auto wkb : {native, swapped}) {
+        BOOST_CHECK(same_outer(poly, per_point(wkb)));
+        BOOST_CHECK(same_outer(poly, bulk(wkb)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(geometry_wkb_benchmark, *boost::unit_test::disabled())
+{
+    using clock = std::chrono::steady_clock;
+    auto [poly, native, swapped] = wkb_ring(1'000'000);
+    auto measure = [&](char const* name, auto decode, boat::blob_view wkb) {
+        auto start = clock::now();
+        for (int i{}; i < 10; ++i)
+            BOOST_CHECK(same_outer(poly, decode(wkb)));
+        std::cout << name << ": "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         clock::now() - start)
+                  << "\n";
+    };
+    measure("wkb per point native", per_point, native);
+    measure("wkb per point swapped", per_point, swapped);
+    measure("wkb bulk native", bulk, native);
+    measure("wkb bulk swapped", bulk, swapped);
+}
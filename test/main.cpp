@@ -3,6 +3,8 @@
 #define BOOST_TEST_MODULE boat
 
 #include <boat/blob.hpp>
+#include <boat/catalog_pool.hpp>
+#include <boat/db/column_batch.hpp>
 #include <boat/db/io.hpp>
 #include <boat/db/reflection.hpp>
 #include <boat/detail/unicode.hpp>
@@ -1,8 +1,12 @@
 // Andrew Naplavkov
 
+#include <boat/catalog_pool.hpp>
+#include <boat/gui/pyramid.hpp>
 #include <boat/sql/catalog.hpp>
 #include <boat/sql/odbc/drivers.hpp>
 #include <boost/test/unit_test.hpp>
+#include <filesystem>
+#include <thread>
 #include "commands.hpp"
 #include "data.hpp"
 
@@ -32,6 +36,255 @@ BOOST_AUTO_TEST_CASE(sql_select)
             BOAT_LIFT(boost::pfr::eq_fields)));
 }
 
+BOOST_AUTO_TEST_CASE(sql_catalog_pool)
+{
+    auto adr = "sqlite:///:memory:";
+    auto pool = catalog_pool{{.max_per_address = 1, .max_wait{}}};
+    auto cat = static_cast<db::catalog*>(nullptr);
+    {
+        auto lease = pool.get(adr);
+        cat = &*lease;
+        BOOST_CHECK_THROW(pool.get(adr), std::runtime_error);  //< limit
+    }
+    BOOST_CHECK_EQUAL(&*pool.get(adr), cat);  //< warm
+    BOOST_CHECK_NO_THROW(pool.get(adr)->ping());
+    try {
+        auto lease = pool.get(adr);
+        throw std::logic_error{"discard"};
+    }
+    catch (std::logic_error const&) {
+    }
+    BOOST_CHECK(pool.get(adr));  //< reopened
+    {
+        auto reader = pool.get_shared(adr);
+        auto copy = reader;
+        reader.reset();
+        BOOST_CHECK_THROW(pool.get(adr), std::runtime_error);  //< copy holds
+    }
+    BOOST_CHECK(pool.get_shared(adr));  //< returned with the last holder
+}
+
+BOOST_AUTO_TEST_CASE(sql_schema_change)
+{
+    auto sel = db::query{"select * from boat_ddl where 0 < ", db::variant{1}};
+    for (auto cmd : commands()) {
+        auto cat = sql::catalog{};
+        cat.command = std::move(cmd);
+        cat.drop({}, "boat_ddl");
+        cat.command->exec("create table boat_ddl (i int)");
+        cat.command->exec(sel);  //< prepared
+        cat.drop({}, "boat_ddl");
+        cat.command->exec("create table boat_ddl (i int, s varchar(8))");
+        BOOST_CHECK_EQUAL(cat.command->exec(sel).columns.size(), 2u);
+        cat.drop({}, "boat_ddl");
+    }
+    auto cmd = sql::make_command(config::postgres_address);
+    cmd->exec("drop table if exists boat_ddl; create table boat_ddl (i int)");
+    cmd->exec(sel);
+    cmd->exec("drop table boat_ddl; create table boat_ddl (i int, s text)");
+    BOOST_CHECK_EQUAL(cmd->exec(sel).columns.size(), 2u);  //< re-prepared
+    cmd->exec("drop table boat_ddl");
+}
+
+BOOST_AUTO_TEST_CASE(sql_postgres_numeric)
+{
+    auto cmd = sql::make_command(config::postgres_address);
+    auto& pq = dynamic_cast<sql::libpq::command&>(*cmd);
+    pq.exec({"select ", db::variant{1}});
+    auto cached = pq.statements().size();
+    auto qry = db::query{"select 'Infinity'::numeric, '-Infinity'::numeric, ",
+                         db::variant{1}};
+    for (auto&& rs : cmd->scan(qry, 1)) {  //< binary format
+        BOOST_CHECK_EQUAL(db::get<double>(rs.rows[0][0]), INFINITY);
+        BOOST_CHECK_EQUAL(db::get<double>(rs.rows[0][1]), -INFINITY);
+    }
+    BOOST_CHECK_EQUAL(pq.statements().size(), cached);  //< cursor not cached
+}
+
+BOOST_AUTO_TEST_CASE(sql_long_value)
+{
+    auto str = std::string(10'000, 'x');
+    auto qry = db::query{"select ", db::variant{str}};
+    for (auto cmd : commands())
+        BOOST_CHECK_EQUAL(db::get<std::string>(cmd->exec(qry).value()), str);
+}
+
+BOOST_AUTO_TEST_CASE(sql_cancel)
+{
+    auto interrupt = [](db::command& cmd, db::query const& qry) {
+        auto canceller = std::jthread{[&](std::stop_token tok) {
+            while (!tok.stop_requested()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+                cmd.cancel();
+            }
+        }};
+        BOOST_CHECK_THROW(cmd.exec(qry), std::runtime_error);
+        canceller = {};  //< join
+        cmd.cancel();    //< idle, the next query is not affected
+        BOOST_CHECK_EQUAL(db::get<int64_t>(cmd.exec("select 1").value()), 1);
+    };
+    interrupt(*sql::make_command("sqlite:///:memory:"),
+              {"with recursive n(i) as (select 1 union all select i + 1 "
+               "from n) select count(*) from n"});  //< endless
+    interrupt(*sql::make_command(config::mysql_address),
+              {"select benchmark(1000000000000, md5('boat'))"});
+}
+
+BOOST_AUTO_TEST_CASE(sql_visit)
+{
+    auto own = overloaded{
+        [](blob_view v) { return db::variant{blob{v.data(), v.size()}}; },
+        [](auto v) { return db::variant{v}; }};
+    auto qry = db::query{"select 1, 'a' union select 2, null"};
+    for (auto cmd : commands()) {
+        auto expect = cmd->exec(qry).rows;
+        expect.append_range(std::vector{expect});
+        auto rows = decltype(expect){};
+        cmd->visit({qry, qry}, [&](size_t, auto row) {
+            rows.push_back(row | std::views::transform([&](auto& var) {
+                               return std::visit(own, var);
+                           }) |
+                           std::ranges::to<std::vector>());
+        });
+        BOOST_CHECK(rows == expect);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sql_inline_params)
+{
+    auto txt = std::string{"a\\'b"};
+    auto qry = db::query{"select ", db::variant{txt}};
+    for (auto cmd : commands()) {
+        for (auto&& rs : cmd->exec_many({qry}))
+            BOOST_CHECK_EQUAL(db::get<std::string>(rs.value()), txt);
+        for (auto&& rs : cmd->scan(qry, 1))
+            BOOST_CHECK_EQUAL(db::get<std::string>(rs.value()), txt);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sql_scan_columns)
+{
+    auto qry = db::query{"select 1, 'a' union select 2, null"};
+    for (auto cmd : commands()) {
+        auto expect = cmd->exec(qry).rows;
+        auto rows = decltype(expect){};
+        for (auto&& cb : cmd->scan_columns(qry, 1))
+            rows.append_range(db::to_rowset(cb).rows);
+        BOOST_CHECK(rows == expect);
+    }
+    auto cmd = sql::make_command("sqlite:///:memory:");
+    qry = {"select 1 union all select 'a'"};  //< dynamic typing
+    auto expect = cmd->exec(qry).rows;
+    auto rows = decltype(expect){};
+    for (auto&& cb : cmd->scan_columns(qry, 2))
+        rows.append_range(db::to_rowset(cb).rows);
+    BOOST_CHECK(rows == expect);
+}
+
+BOOST_AUTO_TEST_CASE(sql_bulk_load)
+{
+    auto cat = sql::catalog{};
+    cat.command = sql::make_command("sqlite:///:memory:");
+    auto tbl = cat.create(get_table());
+    cat.set_autocommit(false);
+    cat.insert(tbl, db::to_rowset(get_objects()));
+    cat.commit();
+    cat.set_autocommit(true);
+    auto bbox = db::bbox{
+        .select_list{std::string(boost::pfr::get_name<0, udt>())},
+        .xmin = 9,
+        .ymin = 9,
+        .xmax = 11,
+        .ymax = 11,
+        .limit = 2,
+    };
+    BOOST_CHECK(std::ranges::equal(std::array{2},
+                                   cat.select(tbl, bbox) | db::view<int>));
+    BOOST_CHECK_EQUAL(
+        cat.get_table(tbl.schema_name, tbl.table_name).index_keys.size(),
+        tbl.index_keys.size());  //< spatial index rebuilt
+}
+
+BOOST_AUTO_TEST_CASE(sql_bulk_load_interrupted)
+{
+    auto file = std::filesystem::temp_directory_path() / "boat_bulk_load.db";
+    std::filesystem::remove(file);
+    auto url = concat("sqlite:///", file.string());
+    auto tbl = db::table{};
+    {
+        auto cat = sql::catalog{};
+        cat.command = sql::make_command(url);
+        tbl = cat.create(get_table());
+        cat.set_autocommit(false);
+        cat.insert(tbl, db::to_rowset(get_objects()));
+        cat.commit();
+    }  //< as if the load threw
+    auto cat = sql::catalog{};
+    cat.command = sql::make_command(url);
+    BOOST_CHECK_EQUAL(
+        cat.get_table(tbl.schema_name, tbl.table_name).index_keys.size(),
+        tbl.index_keys.size());
+    cat.command.reset();
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(sql_read_only)
+{
+    auto file = std::filesystem::temp_directory_path() / "boat_read_only.db";
+    std::filesystem::remove(file);
+    auto url = concat("sqlite:///", file.string());
+    sql::make_command(url)->exec("create table t as select 1 i");
+    auto cmd = sql::make_command(concat(url, "?mode=ro"));
+    BOOST_CHECK_EQUAL(db::get<int64_t>(cmd->exec("select i from t").value()),
+                      1);
+    BOOST_CHECK_THROW(cmd->exec("insert into t values (2)"),
+                      std::runtime_error);
+    cmd.reset();
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(sql_pyramid)
+{
+    auto src = sql::catalog{};
+    src.command = sql::make_command("sqlite:///:memory:");
+    auto tbl = src.create(get_table());
+    src.insert(tbl, db::to_rowset(get_objects()));
+    auto sidecar = std::make_unique<sql::catalog>();
+    sidecar->command = sql::make_command("sqlite:///:memory:");
+    auto lod = gui::pyramid{std::move(sidecar)};
+    lod.build(src, tbl, boost::pfr::get_name<2, udt>(), 4);
+    auto lvls = lod.levels();
+    BOOST_CHECK_EQUAL(lvls.size(), 4u);
+    BOOST_CHECK(!lod.find(lvls.back().tolerance / 2));  //< finer than all
+    auto lvl = lod.find(lvls.front().tolerance);
+    BOOST_REQUIRE(lvl);
+    auto rq =
+        db::bbox{.xmin = 0, .ymin = 0, .xmax = 50, .ymax = 50, .limit = 2};
+    auto rows = 0;
+    lod.visit(std::vector{std::pair{lvl->id, rq}},
+              [&](size_t, auto) { ++rows; });
+    BOOST_CHECK_EQUAL(rows, 2);
+    BOOST_CHECK(lod.fresh(src, tbl, boost::pfr::get_name<2, udt>()));
+    auto null_geom = db::rowset{};
+    null_geom.columns = {std::string(boost::pfr::get_name<0, udt>())};
+    null_geom.rows.push_back({int64_t{99}});
+    src.insert(tbl, null_geom);
+    BOOST_CHECK(lod.fresh(src, tbl, boost::pfr::get_name<2, udt>()));
+    auto objs = get_objects();
+    objs.front().id = 100;
+    src.insert(tbl, db::to_rowset(objs | std::views::take(1)));
+    BOOST_CHECK(!lod.fresh(src, tbl, boost::pfr::get_name<2, udt>()));
+    lod.build(src, tbl, boost::pfr::get_name<2, udt>(), 2);
+    BOOST_CHECK(lod.fresh(src, tbl, boost::pfr::get_name<2, udt>()));
+    BOOST_CHECK_EQUAL(lod.levels().size(), 2u);
+    BOOST_CHECK_NE(lod.levels().front().id, lvl->id);  //< not reused
+    rq.limit = 10;
+    rows = 0;
+    lod.visit(std::vector{std::pair{lod.levels().front().id, rq}},
+              [&](size_t, auto) { ++rows; });
+    BOOST_CHECK_EQUAL(rows, 3);  //< no point for the null geometry
+}
+
 BOOST_AUTO_TEST_CASE(sql_vector)
 {
     for (auto cmd : commands()) {
@@ -148,6 +401,19 @@ auto datatypes_query(std::string_view dbms)
 
 }  // namespace
 
+BOOST_AUTO_TEST_CASE(sql_mysql_unsigned)
+{
+    auto cmd = sql::make_command(config::mysql_address);
+    auto max = std::string{"18446744073709551615"};
+    auto expect = static_cast<double>(UINT64_MAX);
+    auto text = db::query{"select cast(", max, " as unsigned)"};
+    auto binary = db::query{"select cast(", db::variant{max}, " as unsigned)"};
+    for (auto& qry : {text, binary})
+        BOOST_CHECK_EQUAL(db::get<double>(cmd->exec(qry).value()), expect);
+    for (auto&& rs : cmd->scan(text, 1))
+        BOOST_CHECK_EQUAL(db::get<double>(rs.value()), expect);
+}
+
 BOOST_AUTO_TEST_CASE(sql_datatypes)
 {
     auto tbl_a_name = "datatypes";
@@ -163,6 +429,8 @@ BOOST_AUTO_TEST_CASE(sql_datatypes)
         auto rs = cat.select(tbl_a, page);
         BOOST_CHECK_EQUAL(tbl_a.columns.size(), rs.columns.size());
         BOOST_CHECK(!rs.empty());
+        for (auto&& batch : cat.scan(tbl_a, {}, 1))
+            BOOST_CHECK(batch.rows == rs.rows);
         auto tbl_b = tbl_a;
         tbl_b.table_name = tbl_b_name;
         tbl_b = cat.create(tbl_b);